@@ -17,6 +17,7 @@
 #include "ddramc.h"
 #include "sdramc.h"
 #include "timer.h"
+#include "bootstage.h"
 #include "watchdog.h"
 #include "string.h"
 #include "sam9x60_board.h"
@@ -314,6 +315,7 @@ void hw_init(void)
 
 	/* Init timer */
 	timer_init();
+	bootstage_mark(BOOTSTAGE_CLOCK);
 
 #ifdef CONFIG_TWI
 	twi_init();
@@ -336,6 +338,7 @@ void hw_init(void)
 	/* Initialize SDRAM Controller */
 	sdramc_init();
 #endif
+	bootstage_mark(BOOTSTAGE_DRAM);
 
 #ifdef CONFIG_BOARD_QUIRK_SAM9X60_EK
 	/* Perform the WILC initialization sequence */
@@ -578,6 +581,20 @@ void mmu_tlb_init(unsigned int *tlb)
 	                  | TTB_SECT_SBO
 	                  | TTB_TYPE_SECT;
 
+	/* 0x80000000: SDMMC0, 0x90000000: SDMMC1 */
+	tlb[0x800] = TTB_SECT_ADDR(0x80000000)
+	           | TTB_SECT_AP_FULL_ACCESS
+	           | TTB_SECT_DOMAIN(0xf)
+	           | TTB_SECT_STRONGLY_ORDERED
+	           | TTB_SECT_SBO
+	           | TTB_TYPE_SECT;
+	tlb[0x900] = TTB_SECT_ADDR(0x90000000)
+	           | TTB_SECT_AP_FULL_ACCESS
+	           | TTB_SECT_DOMAIN(0xf)
+	           | TTB_SECT_STRONGLY_ORDERED
+	           | TTB_SECT_SBO
+	           | TTB_TYPE_SECT;
+
 	/* 0xf0000000: Peripherals */
 	tlb[0xf00] = TTB_SECT_ADDR(0xf0000000)
 	           | TTB_SECT_AP_FULL_ACCESS
@@ -16,6 +16,7 @@
 #include "debug.h"
 #include "ddramc.h"
 #include "timer.h"
+#include "bootstage.h"
 #include "watchdog.h"
 #include "string.h"
 #include "sam9x7_board.h"
@@ -316,6 +317,7 @@ void hw_init(void)
 
 	/* Init timer */
 	timer_init();
+	bootstage_mark(BOOTSTAGE_CLOCK);
 
 #ifdef CONFIG_TWI
 	twi_init();
@@ -337,6 +339,7 @@ void hw_init(void)
 	/* Initialize DDRAM Controller */
 	ddram_init();
 #endif
+	bootstage_mark(BOOTSTAGE_DRAM);
 
 #ifdef CONFIG_BOARD_QUIRK_SAM9X75_CURIOSITY
 	at91_rio0_select();
@@ -576,6 +579,20 @@ void mmu_tlb_init(unsigned int *tlb)
 	                  | TTB_SECT_SBO
 	                  | TTB_TYPE_SECT;
 
+	/* 0x80000000: SDMMC0, 0x90000000: SDMMC1 */
+	tlb[0x800] = TTB_SECT_ADDR(0x80000000)
+	           | TTB_SECT_AP_FULL_ACCESS
+	           | TTB_SECT_DOMAIN(0xf)
+	           | TTB_SECT_STRONGLY_ORDERED
+	           | TTB_SECT_SBO
+	           | TTB_TYPE_SECT;
+	tlb[0x900] = TTB_SECT_ADDR(0x90000000)
+	           | TTB_SECT_AP_FULL_ACCESS
+	           | TTB_SECT_DOMAIN(0xf)
+	           | TTB_SECT_STRONGLY_ORDERED
+	           | TTB_SECT_SBO
+	           | TTB_TYPE_SECT;
+
 	/* 0xf0000000: Peripherals */
 	tlb[0xf00] = TTB_SECT_ADDR(0xf0000000)
 	           | TTB_SECT_AP_FULL_ACCESS
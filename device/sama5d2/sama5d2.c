@@ -13,6 +13,7 @@
 #include "pmc.h"
 #include "string.h"
 #include "timer.h"
+#include "bootstage.h"
 #include "usart.h"
 #include "watchdog.h"
 #include "sdhc_cal.h"
@@ -521,6 +522,7 @@ void hw_init(void)
 	initialize_dbgu();
 
 	timer_init();
+	bootstage_mark(BOOTSTAGE_CLOCK);
 
 #if defined(CONFIG_TWI)
 	flexcoms_init(flexcoms);
@@ -528,6 +530,7 @@ void hw_init(void)
 #endif
 
 	ddram_init();
+	bootstage_mark(BOOTSTAGE_DRAM);
 
 	l2cache_prepare();
 
@@ -941,6 +944,22 @@ void mmu_tlb_init(unsigned int *tlb)
 	                  | TTB_SECT_STRONGLY_ORDERED
 	                  | TTB_TYPE_SECT;
 
+	/* 0xa0000000: SDMMC0 */
+	tlb[0xa00] = TTB_SECT_ADDR(0xa0000000)
+	           | TTB_SECT_AP_FULL_ACCESS
+	           | TTB_SECT_DOMAIN(0xf)
+	           | TTB_SECT_EXEC_NEVER
+	           | TTB_SECT_STRONGLY_ORDERED
+	           | TTB_TYPE_SECT;
+
+	/* 0xb0000000: SDMMC1 */
+	tlb[0xb00] = TTB_SECT_ADDR(0xb0000000)
+	           | TTB_SECT_AP_FULL_ACCESS
+	           | TTB_SECT_DOMAIN(0xf)
+	           | TTB_SECT_EXEC_NEVER
+	           | TTB_SECT_STRONGLY_ORDERED
+	           | TTB_TYPE_SECT;
+
 	/* 0xd0000000: QSPI0/1 MEM */
 	for (addr = 0xd00; addr < 0xe00; addr++)
 		tlb[addr] = TTB_SECT_ADDR(addr << 20)
@@ -59,6 +59,8 @@
 #if CONFIG_SPI_BUS == 0
 	#define CONFIG_SYS_BASE_SPI	AT91C_BASE_SPI0
 	#define CONFIG_SYS_ID_SPI	AT91C_ID_SPI0
+	#define CONFIG_SYS_SPI_PERID_TX	AT91C_XDMAC_PERID_SPI0_TX
+	#define CONFIG_SYS_SPI_PERID_RX	AT91C_XDMAC_PERID_SPI0_RX
 	#if CONFIG_SPI_IOSET == 1
 		#define CONFIG_SYS_SPI_PCS	AT91C_PIN_PA(17)
 	#elif CONFIG_SPI_IOSET == 2
@@ -69,6 +71,8 @@
 #elif CONFIG_SPI_BUS == 1
 	#define CONFIG_SYS_BASE_SPI	AT91C_BASE_SPI1
 	#define CONFIG_SYS_ID_SPI	AT91C_ID_SPI1
+	#define CONFIG_SYS_SPI_PERID_TX	AT91C_XDMAC_PERID_SPI1_TX
+	#define CONFIG_SYS_SPI_PERID_RX	AT91C_XDMAC_PERID_SPI1_RX
 	#if CONFIG_SPI_IOSET == 1
 		#define CONFIG_SYS_SPI_PCS	AT91C_PIN_PC(4)
 	#elif CONFIG_SPI_IOSET == 2
@@ -11,6 +11,7 @@
 #include "spi.h"
 #include "gpio.h"
 #include "timer.h"
+#include "bootstage.h"
 #include "watchdog.h"
 #include "string.h"
 #include "board_hw_info.h"
@@ -261,11 +262,13 @@ void hw_init(void)
 
 	/* Init timer */
 	timer_init();
+	bootstage_mark(BOOTSTAGE_CLOCK);
 
 	/* initialize the dbgu */
 	initialize_dbgu();
 
 	ddram_init();
+	bootstage_mark(BOOTSTAGE_DRAM);
 
 #ifdef CONFIG_LOAD_ONE_WIRE
 	/* load one wire information */
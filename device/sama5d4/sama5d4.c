@@ -11,6 +11,7 @@
 #include "spi.h"
 #include "gpio.h"
 #include "timer.h"
+#include "bootstage.h"
 #include "watchdog.h"
 #include "string.h"
 
@@ -441,8 +442,10 @@ void hw_init(void)
 
 	/* Init timer */
 	timer_init();
+	bootstage_mark(BOOTSTAGE_CLOCK);
 
 	ddram_init();
+	bootstage_mark(BOOTSTAGE_DRAM);
 
 #if defined(CONFIG_HDMI) && defined(CONFIG_BOARD_QUIRK_SAMA5D4)
 	/* Reset HDMI SiI9022 */
@@ -22,6 +22,7 @@
 #include "umctl2.h"
 #include "watchdog.h"
 #include "timer.h"
+#include "bootstage.h"
 #include "sdhc_cal.h"
 #include "led.h"
 #include "arch/tz_matrix.h"
@@ -564,6 +565,11 @@ static void umctl2_config_state_init()
 	umctl2_config.phy_zq_recalibrate = &publ_zq_recalibrate;
 	umctl2_config.phy_train_corrupted_data_restore = &publ_train_corrupted_data_restore;
 #endif
+#ifdef CONFIG_PUBL_TRAINING_CACHE
+	umctl2_config.phy_restore_training = &publ_restore_training;
+	umctl2_config.phy_save_training = &publ_save_training;
+	umctl2_config.phy_drop_training = &publ_drop_training;
+#endif
 }
 
 #ifdef CONFIG_DATAFLASH
@@ -1212,6 +1218,7 @@ void hw_init(void)
 
 	/* We need timers in the following steps */
 	timer_init();
+	bootstage_mark(BOOTSTAGE_CLOCK);
 
 #ifdef CONFIG_TWI
 	twi_init();
@@ -1275,6 +1282,7 @@ void hw_init(void)
 	} else if (!backup_resume()) {
 		console_printf("UMCTL2: Initialization complete.\n");
 	}
+	bootstage_mark(BOOTSTAGE_DRAM);
 
 	at91_init_can_message_ram();
 
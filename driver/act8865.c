@@ -8,6 +8,7 @@
 #include "twi.h"
 #include "act8865.h"
 #include "debug.h"
+#include "usart.h"
 
 /*
  * ACT8865 Device Slave Address
@@ -250,6 +251,7 @@ void act8865_workaround(void)
 	/* Disable ACT8865 I2C interface, if failed, don't go on */
 	if (act8865_workaround_disable_i2c()) {
 		console_printf("ACT8865: Failed to disable I2C interface\n");
+		usart_flush();
 		while (1)
 			;
 	}
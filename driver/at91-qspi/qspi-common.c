@@ -9,6 +9,7 @@
 #include "arch/at91-qspi/qspi.h"
 #include "spi_flash/spi_nor.h"
 #include "debug.h"
+#include "bootstage.h"
 
 #include "qspi-common.h"
 #ifdef CONFIG_QSPI_DMA_SUPPORT
@@ -139,6 +140,7 @@ int qspi_loadimage(struct image_info *image)
 		spi_flash_cleanup(&flash);
 		return -1;
 	}
+	bootstage_mark(BOOTSTAGE_MEDIA_INIT);
 
 	return spi_flash_loadimage(&flash, image);
 }
@@ -164,32 +166,24 @@ void *qspi_memcpy(void *dst, const void *src, int cnt)
 {
 #ifdef CONFIG_QSPI_DMA_SUPPORT
 	struct xdmac_hwcfg hwcfg;
-	struct xdmac_cfg cfg;
-	struct xdmac_transfer_cfg transfer_cfg;
 	int ret;
 
 	if (cnt > QSPID_XDMA_SIZE_THRESHOLD) {
 		hwcfg.pid = 0xFF;
-		hwcfg.cid = 0;
 		hwcfg.src_is_periph = 0;
 		hwcfg.dst_is_periph = 0;
-		cfg.data_width = DMA_DATA_WIDTH_BYTE;
-		cfg.chunk_size = DMA_CHUNK_SIZE_1;
-		cfg.burst_size = DMA_MEM_BURST_16;
-		cfg.incr_saddr = 1;
-		cfg.incr_daddr = 1;
-		ret = xdmac_configure_transfer(&hwcfg, &cfg);
-		if (ret)
-			goto dma_stop;
-		transfer_cfg.saddr = (void *)src;
-		transfer_cfg.daddr = (void *)dst;
-		transfer_cfg.len = cnt;
-		ret = xdmac_transfer_start(&hwcfg, &transfer_cfg);
-		if (ret)
-			goto dma_stop;
-		ret = xdmac_transfer_wait_for_completion(&hwcfg);
-dma_stop:
-		xdmac_transfer_stop(&hwcfg);
+		if (!xdmac_request_channel(&hwcfg)) {
+			ret = xdmac_memcpy(&hwcfg, dst, src, cnt);
+			xdmac_transfer_stop(&hwcfg);
+
+			/* do not hand a partial copy over as the flash data */
+			if (ret) {
+				dbg_info("QSPI: DMA copy failed, using the CPU\n");
+				memcpy(dst, src, cnt);
+			}
+		} else {
+			memcpy(dst, src, cnt);
+		}
 	} else {
 		while (cnt--)
 			*(char *)dst++ = *(char *)src++;
@@ -9,6 +9,13 @@
 #include "debug.h"
 #include "board.h"
 #include "string.h"
+#include "timer.h"
+#ifdef CONFIG_AES_DMA
+#include "xdmac.h"
+#ifdef CONFIG_CACHES
+#include "l1cache.h"
+#endif
+#endif
 
 #define swab32(x) (			\
 	(((x) & 0x000000ffUL) << 24) |	\
@@ -78,10 +85,16 @@ static inline void at91_aes_set_iv(const unsigned int *iv)
 static inline int at91_aes_set_opmode(at91_aes_operation_t operation,
 				      at91_aes_mode_t mode,
 				      at91_aes_key_size_t key_size,
+				      unsigned int use_dma,
 				      unsigned int *data_width,
 				      unsigned int *chunk_size)
 {
-	unsigned int mr = AES_MR_CKEY_PASSWD | AES_MR_SMOD_AUTO_START;
+	unsigned int mr = AES_MR_CKEY_PASSWD;
+
+	if (use_dma)
+		mr |= AES_MR_SMOD_IDATAR0_START | AES_MR_DUALBUFF;
+	else
+		mr |= AES_MR_SMOD_AUTO_START;
 
 	switch (operation) {
 	case AT91_AES_OP_DECRYPT:
@@ -216,12 +229,28 @@ static inline int at91_aes_set_key(at91_aes_key_size_t key_size,
 	return 0;
 }
 
+/* One block takes a few dozen cycles, so this only catches a stuck AES */
+#define AES_DATRDY_TIMEOUT_US	1000
+
+static int at91_aes_wait_ready(void)
+{
+	unsigned long long deadline = deadline_from_us(AES_DATRDY_TIMEOUT_US);
+
+	while (!(aes_readl(AES_ISR) & AES_INT_DATRDY)) {
+		if (deadline_expired(deadline)) {
+			dbg_info("AES: Timeout waiting for data ready\n");
+			return -1;
+		}
+	}
+
+	return 0;
+}
 
-static void at91_aes_compute_pio_long(unsigned int chunk_size,
-				      unsigned int num_blocks,
-				      unsigned int is_mac,
-				      const unsigned int *input,
-				      unsigned int *output)
+static int at91_aes_compute_pio_long(unsigned int chunk_size,
+				     unsigned int num_blocks,
+				     unsigned int is_mac,
+				     const unsigned int *input,
+				     unsigned int *output)
 {
 	unsigned int n, i, reg;
 
@@ -230,7 +259,8 @@ static void at91_aes_compute_pio_long(unsigned int chunk_size,
 		for (i = 0; i < chunk_size; ++i, reg += 4)
 			aes_writel(reg, *input++);
 
-		while (!(aes_readl(AES_ISR) & AES_INT_DATRDY));
+		if (at91_aes_wait_ready())
+			return -1;
 		if (is_mac)
 			continue;
 
@@ -238,79 +268,192 @@ static void at91_aes_compute_pio_long(unsigned int chunk_size,
 		for (i = 0; i < chunk_size; ++i, reg += 4)
 			*output++ = aes_readl(reg);
 	}
+
+	return 0;
 }
 
-static void at91_aes_compute_pio_word(unsigned int num_blocks,
-				      unsigned int is_mac,
-				      const unsigned short *input,
-				      unsigned short *output)
+static int at91_aes_compute_pio_word(unsigned int num_blocks,
+				     unsigned int is_mac,
+				     const unsigned short *input,
+				     unsigned short *output)
 {
 	unsigned int n;
 
 	for (n = 0; n < num_blocks; ++n) {
 		aes_writew(AES_IDATAR0, *input++);
 
-		while (!(aes_readl(AES_ISR) & AES_INT_DATRDY));
+		if (at91_aes_wait_ready())
+			return -1;
 		if (is_mac)
 			continue;
 
 		*output++ = aes_readw(AES_ODATAR0);
 	}
+
+	return 0;
 }
 
-static void at91_aes_compute_pio_byte(unsigned int num_blocks,
-				      unsigned int is_mac,
-				      const unsigned char *input,
-				      unsigned char *output)
+static int at91_aes_compute_pio_byte(unsigned int num_blocks,
+				     unsigned int is_mac,
+				     const unsigned char *input,
+				     unsigned char *output)
 {
 	unsigned int n;
 
 	for (n = 0; n < num_blocks; ++n) {
 		aes_writeb(AES_IDATAR0, *input++);
 
-		while (!(aes_readl(AES_ISR) & AES_INT_DATRDY));
+		if (at91_aes_wait_ready())
+			return -1;
 		if (is_mac)
 			continue;
 
 		*output++ = aes_readb(AES_ODATAR0);
 	}
+
+	return 0;
 }
 
-static void at91_aes_compute_pio(unsigned int data_width,
-				 unsigned int chunk_size,
-				 unsigned int num_blocks,
-				 unsigned int is_mac,
-				 const void *input,
-				 void *output)
+static int at91_aes_compute_pio(unsigned int data_width,
+				unsigned int chunk_size,
+				unsigned int num_blocks,
+				unsigned int is_mac,
+				const void *input,
+				void *output)
 {
 	switch (data_width) {
 	case 4:
-		at91_aes_compute_pio_long(chunk_size,
-					  num_blocks,
-					  is_mac,
-					  (const unsigned int *)input,
-					  (unsigned int *)output);
-		break;
+		return at91_aes_compute_pio_long(chunk_size,
+						 num_blocks,
+						 is_mac,
+						 (const unsigned int *)input,
+						 (unsigned int *)output);
 
 	case 2:
-		at91_aes_compute_pio_word(num_blocks,
-					  is_mac,
-					  (const unsigned short *)input,
-					  (unsigned short *)output);
-		break;
+		return at91_aes_compute_pio_word(num_blocks,
+						 is_mac,
+						 (const unsigned short *)input,
+						 (unsigned short *)output);
 
 	case 1:
-		at91_aes_compute_pio_byte(num_blocks,
-					  is_mac,
-					  (const unsigned char *)input,
-					  (unsigned char *)output);
-		break;
+		return at91_aes_compute_pio_byte(num_blocks,
+						 is_mac,
+						 (const unsigned char *)input,
+						 (unsigned char *)output);
 
 	default:
-		break;
+		return 0;
 	}
 }
 
+#ifdef CONFIG_AES_DMA
+/*
+ * DMA mode: one XDMAC channel feeds IDATAR0 from memory while a second
+ * one drains ODATAR0 to memory, each following a descriptor list, so
+ * the CPU only waits for the end of the whole run. In MAC mode (LOD)
+ * the output is not read back, only the last block matters.
+ */
+#define AES_DMA_MIN_BLOCKS	16
+#define AES_DMA_MAX_DESC	4
+
+static struct xdmac_desc aes_tx_desc[AES_DMA_MAX_DESC];
+static struct xdmac_desc aes_rx_desc[AES_DMA_MAX_DESC];
+
+static int at91_aes_start_dma(struct xdmac_hwcfg *hwcfg,
+			      struct xdmac_desc *desc,
+			      unsigned int incr_saddr,
+			      void *saddr, void *daddr,
+			      unsigned int length)
+{
+	struct xdmac_cfg cfg;
+	struct xdmac_transfer_cfg transfer_cfg;
+
+	cfg.data_width = DMA_DATA_WIDTH_WORD;
+	cfg.chunk_size = DMA_CHUNK_SIZE_4;
+	cfg.burst_size = DMA_MEM_BURST_16;
+	cfg.incr_saddr = incr_saddr;
+	cfg.incr_daddr = !incr_saddr;
+
+	transfer_cfg.saddr = saddr;
+	transfer_cfg.daddr = daddr;
+	transfer_cfg.len = length;
+
+	if (xdmac_configure_transfer(hwcfg, &cfg))
+		return -1;
+
+	if (xdmac_prepare_list(desc, AES_DMA_MAX_DESC, &cfg, &transfer_cfg) < 0)
+		return -1;
+
+	return xdmac_transfer_start_list(hwcfg, desc);
+}
+
+static int at91_aes_compute_dma(unsigned int num_blocks,
+				unsigned int is_mac,
+				const void *input,
+				void *output)
+{
+	struct xdmac_hwcfg tx_hwcfg = {
+		.pid = AT91C_ID_AES,
+		.dst_is_periph = 1,
+		.txif = AT91C_XDMAC_PERID_AES_TX,
+	};
+	struct xdmac_hwcfg rx_hwcfg = {
+		.pid = AT91C_ID_AES,
+		.src_is_periph = 1,
+		.rxif = AT91C_XDMAC_PERID_AES_RX,
+	};
+	unsigned int length = num_blocks * AT91_AES_BLOCK_SIZE_BYTE;
+	int ret;
+
+	if (xdmac_request_channel(&tx_hwcfg))
+		return -1;
+
+	if (!is_mac && xdmac_request_channel(&rx_hwcfg)) {
+		xdmac_transfer_stop(&tx_hwcfg);
+		return -1;
+	}
+
+#ifdef CONFIG_CACHES
+	/* the input may still be in the cache, the output must not be */
+	dcache_clean();
+#endif
+
+	if (!is_mac) {
+		ret = at91_aes_start_dma(&rx_hwcfg, aes_rx_desc, 0,
+					 (void *)(AT91C_BASE_AES + AES_ODATAR0),
+					 output, length);
+		if (ret)
+			goto dma_stop;
+	}
+
+	ret = at91_aes_start_dma(&tx_hwcfg, aes_tx_desc, 1, (void *)input,
+				 (void *)(AT91C_BASE_AES + AES_IDATAR0), length);
+	if (ret)
+		goto dma_stop;
+
+	ret = xdmac_list_wait_for_completion(&tx_hwcfg);
+	if (!ret && !is_mac)
+		ret = xdmac_list_wait_for_completion(&rx_hwcfg);
+
+	/* the last block leaves the AES after its input was taken */
+	if (!ret && is_mac)
+		ret = at91_aes_wait_ready();
+
+dma_stop:
+	xdmac_transfer_stop(&tx_hwcfg);
+	if (!is_mac)
+		xdmac_transfer_stop(&rx_hwcfg);
+
+#ifdef CONFIG_CACHES
+	if (!is_mac)
+		dcache_invalidate_region((unsigned int)output,
+					 (unsigned int)output + length);
+#endif
+
+	return ret;
+}
+#endif
+
 static inline unsigned int at91_aes_length2blocks(unsigned int data_length,
 						  unsigned int block_size)
 {
@@ -351,12 +494,26 @@ static int at91_aes_process(const at91_aes_params_t *params)
 	unsigned int data_width, chunk_size;
 	unsigned int block_size, num_blocks;
 	unsigned int is_mac = (params->operation == AT91_AES_OP_MAC);
+	unsigned int use_dma = 0;
+
+#ifdef CONFIG_AES_DMA
+	/* whole 128-bit blocks only, the short runs are left to PIO */
+	num_blocks = at91_aes_length2blocks(params->data_length,
+					    AT91_AES_BLOCK_SIZE_BYTE);
+	use_dma = (num_blocks >= AES_DMA_MIN_BLOCKS) &&
+		  (params->mode == AT91_AES_MODE_ECB ||
+		   params->mode == AT91_AES_MODE_CBC ||
+		   params->mode == AT91_AES_MODE_OFB ||
+		   params->mode == AT91_AES_MODE_CFB_128 ||
+		   params->mode == AT91_AES_MODE_CTR);
+#endif
 
 	/* Reset AES */
 	aes_writel(AES_CR, AES_CR_SWRST);
 
 	if (at91_aes_set_opmode(params->operation, params->mode,
-				params->key_size, &data_width, &chunk_size))
+				params->key_size, use_dma,
+				&data_width, &chunk_size))
 		return -1;
 
 	if (at91_aes_set_key(params->key_size, params->key))
@@ -370,8 +527,16 @@ static int at91_aes_process(const at91_aes_params_t *params)
 
 	block_size = data_width * chunk_size;
 	num_blocks = at91_aes_length2blocks(params->data_length, block_size);
-	at91_aes_compute_pio(data_width, chunk_size, num_blocks,
-			     is_mac, params->input, params->output);
+#ifdef CONFIG_AES_DMA
+	if (use_dma) {
+		if (at91_aes_compute_dma(num_blocks, is_mac,
+					 params->input, params->output))
+			return -1;
+	} else
+#endif
+	if (at91_aes_compute_pio(data_width, chunk_size, num_blocks,
+				 is_mac, params->input, params->output))
+		return -1;
 
 	if (is_mac) {
 		unsigned int reg, i;
@@ -410,34 +575,55 @@ int at91_aes_cbc(unsigned int data_length,
 	return at91_aes_process(&params);
 }
 
-int at91_aes_cmac(unsigned int data_length,
-		  const void *data,
-		  unsigned int *cmac,
-		  at91_aes_key_size_t key_size,
-		  const unsigned int *key)
+int at91_aes_cbc_mac(unsigned int data_length,
+		     const void *data,
+		     unsigned int *mac,
+		     at91_aes_key_size_t key_size,
+		     const unsigned int *key,
+		     const unsigned int *iv)
+{
+	at91_aes_params_t params;
+
+	if (!data_length || !data || !mac || !key || !iv)
+		return -1;
+
+	memset(&params, 0, sizeof(params));
+	params.operation = AT91_AES_OP_MAC;
+	params.mode = AT91_AES_MODE_CBC;
+	params.data_length = data_length;
+	params.input = data;
+	params.output = mac;
+	params.key_size = key_size;
+	params.key = key;
+	params.iv = iv;
+
+	return at91_aes_process(&params);
+}
+
+int at91_aes_cmac_final(const unsigned int *last_block,
+			unsigned int *cmac,
+			at91_aes_key_size_t key_size,
+			const unsigned int *key)
 {
 	static const unsigned int null_block[AT91_AES_BLOCK_SIZE_WORD];
-	static const unsigned int null_iv[AT91_AES_IV_SIZE_WORD];
 	unsigned int last_input[AT91_AES_BLOCK_SIZE_WORD];
 	unsigned int subkey[AT91_AES_BLOCK_SIZE_WORD];
-	const unsigned int *input = (const unsigned int *)data;
-	unsigned int num_blocks, offset;
 	at91_aes_params_t params;
 	unsigned char carry;
 	int i; /* MUST be signed for the subkey loop */
 
-	if (!data_length || !data || !cmac || !key)
+	if (!last_block || !cmac || !key)
 		return -1;
 
 	/* Set common parameters once for all */
 	memset(&params, 0, sizeof(params));
+	params.operation = AT91_AES_OP_ENCRYPT;
+	params.mode = AT91_AES_MODE_ECB;
+	params.data_length = AT91_AES_BLOCK_SIZE_BYTE;
 	params.key_size = key_size;
 	params.key = key;
 
 	/* Generate the subkey */
-	params.operation = AT91_AES_OP_ENCRYPT;
-	params.mode = AT91_AES_MODE_ECB;
-	params.data_length = AT91_AES_BLOCK_SIZE_BYTE;
 	params.input = null_block;
 	params.output = subkey;
 	if (at91_aes_process(&params))
@@ -455,17 +641,34 @@ int at91_aes_cmac(unsigned int data_length,
 	carry = (0 - carry) & 0x87;
 	((unsigned char *)subkey)[AT91_AES_BLOCK_SIZE_BYTE-1] ^= carry;
 
+	/* Process the last block */
+	for (i = 0; i < AT91_AES_BLOCK_SIZE_WORD; ++i)
+		last_input[i] = last_block[i] ^ cmac[i] ^ subkey[i];
+
+	params.input = last_input;
+	params.output = cmac;
+	return at91_aes_process(&params);
+}
+
+int at91_aes_cmac(unsigned int data_length,
+		  const void *data,
+		  unsigned int *cmac,
+		  at91_aes_key_size_t key_size,
+		  const unsigned int *key)
+{
+	static const unsigned int null_iv[AT91_AES_IV_SIZE_WORD];
+	const unsigned int *input = (const unsigned int *)data;
+	unsigned int num_blocks, offset;
+
+	if (!data_length || !data || !cmac || !key)
+		return -1;
+
 	/* Process the n-1 first blocks */
 	num_blocks = at91_aes_length2blocks(data_length,
 					    AT91_AES_BLOCK_SIZE_BYTE);
 	if (num_blocks > 1) {
-		params.operation = AT91_AES_OP_MAC;
-		params.mode = AT91_AES_MODE_CBC;
-		params.iv = null_iv;
-		params.data_length = data_length - AT91_AES_BLOCK_SIZE_BYTE;
-		params.input = data;
-		params.output = cmac;
-		if (at91_aes_process(&params))
+		if (at91_aes_cbc_mac(data_length - AT91_AES_BLOCK_SIZE_BYTE,
+				     data, cmac, key_size, key, null_iv))
 			return -1;
 	} else {
 		memset(cmac, 0, AT91_AES_BLOCK_SIZE_BYTE);
@@ -473,13 +676,5 @@ int at91_aes_cmac(unsigned int data_length,
 
 	/* Process the last block */
 	offset = (num_blocks-1) * AT91_AES_BLOCK_SIZE_WORD;
-	for (i = 0; i < AT91_AES_BLOCK_SIZE_WORD; ++i)
-		last_input[i] = input[offset + i] ^ cmac[i] ^ subkey[i];
-
-	params.operation = AT91_AES_OP_ENCRYPT;
-	params.mode = AT91_AES_MODE_ECB;
-	params.data_length = AT91_AES_BLOCK_SIZE_BYTE;
-	params.input = last_input;
-	params.output = cmac;
-	return at91_aes_process(&params);
+	return at91_aes_cmac_final(&input[offset], cmac, key_size, key);
 }
@@ -8,6 +8,7 @@
 #include "arch/at91_mci.h"
 #include "mci_media.h"
 #include "div.h"
+#include "timer.h"
 #include "debug.h"
 #include "pmc.h"
 
@@ -173,6 +174,22 @@ static int at91_mci_read_data(unsigned int *data)
 	return 0;
 }
 
+#define MCI_DTIP_TIMEOUT_US	10000
+
+static int at91_mci_wait_dtip(void)
+{
+	unsigned long long deadline = deadline_from_us(MCI_DTIP_TIMEOUT_US);
+
+	while (mci_readl(MCI_SR) & AT91C_MCI_DTIP) {
+		if (deadline_expired(deadline)) {
+			dbg_loud("Data Transfer in Progress.\n");
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
 static int at91_mci_read_block_data(unsigned int *data,
 			unsigned int blocks,
 			unsigned int bytes_to_read,
@@ -183,7 +200,6 @@ static int at91_mci_read_block_data(unsigned int *data,
 	unsigned int words_to_read = bytes_to_read >> 2;
 	unsigned int words_of_block = block_len >> 2;
 	unsigned int tmp;
-	int timeout = 10000;
 	int ret;
 
 	for (block = 0; block < blocks; block++) {
@@ -201,15 +217,7 @@ static int at91_mci_read_block_data(unsigned int *data,
 		}
 	}
 
-	while ((mci_readl(MCI_SR) & AT91C_MCI_DTIP) && (--timeout))
-		;
-
-	if (!timeout) {
-		dbg_loud("Data Transfer in Progress.\n");
-		return -1;
-	}
-
-	return 0;
+	return at91_mci_wait_dtip();
 }
 
 static int at91_mci_write_data(unsigned int *data)
@@ -239,7 +247,6 @@ static int at91_mci_write_block_data(unsigned int *data,
 	unsigned int words_to_write = bytes_to_write >> 2;
 	unsigned int words_of_block = block_len >> 2;
 	unsigned int tmp = 0;
-	int timeout = 10000;
 	int ret;
 
 	/* write the valid data of the block */
@@ -258,15 +265,7 @@ static int at91_mci_write_block_data(unsigned int *data,
 		}
 	}
 
-	while ((mci_readl(MCI_SR) & AT91C_MCI_DTIP) && (--timeout))
-		;
-
-	if (!timeout) {
-		dbg_loud("Data Transfer in Progress.\n");
-		return -1;
-	}
-
-	return 0;
+	return at91_mci_wait_dtip();
 }
 
 static int at91_mci_send_command(struct sd_command *command, struct sd_data *data)
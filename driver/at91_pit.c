@@ -5,6 +5,7 @@
 #include "hardware.h"
 #include "board.h"
 #include "debug.h"
+#include "idle.h"
 #include "pmc.h"
 
 #include "arch/at91_pit.h"
@@ -12,6 +13,14 @@
 
 #define MAX_PIV		0xfffff
 
+/*
+ * The PIT counts at MCK / 16, so one microsecond is
+ * 2^32 / PIT_US_MULT ticks. Computed at build time to keep the 64-bit
+ * division out of the image.
+ */
+#define PIT_US_MULT	((unsigned int)((0x100000000ULL * 16 * 1000000) \
+					/ MASTER_CLOCK))
+
 static inline int pit_readl(unsigned int reg)
 {
 	return(readl(AT91C_BASE_PITC + reg));
@@ -46,86 +55,101 @@ static unsigned int at91_get_pit_value(void)
 	return(pit_readl(PIT_PIIR));
 }
 
-/* Because the below statement is used in the function:
- *	((MASTER_CLOCK >> 10) * usec) is used,
- * to our 32-bit system. the argu "usec" maximum value is:
- * supposed "MASTER_CLOCK" is 132M.
- *	132000000 / 1024 = 128906
- *	(0xffffffff) / 128906 = 33318.
- * So the maximum delay time is 33318 us.
+/*
+ * Ticks per microsecond in 16.16 fixed point, for the delays and the
+ * deadlines.
  */
-void udelay(unsigned int usec)
+#define PIT_TICKS_PER_US_Q16	((unsigned int)(((unsigned long long) \
+					MASTER_CLOCK << 16) / (16 * 1000000)))
+
+/* counter value seen by the last get_ticks() and number of wraps */
+static unsigned int pit_last;
+static unsigned int pit_wraps;
+
+/*
+ * The 20-bit CPIV and the 12-bit PICNT fields of PIIR form a single
+ * 32-bit counter since PIV is at its maximum value. It wraps after
+ * minutes, which is extended to 64 bits here: the counter only has to
+ * be read once per wrap period, as any wait loop does.
+ */
+unsigned long long get_ticks(void)
 {
-	unsigned int base = at91_get_pit_value();
-	unsigned int delay;
-	unsigned int current;
-
-	/* Since our division function which costs much run time
-	 * causes the delay time error.
-	 * So here using shifting to implement the division.
-	 * to change "1000" to "1024", this cause some inaccuacy,
-	 * but it is acceptable.
-	 * ((MASTER_CLOCK / 1024) * usec) / (16 * 1024)
-	 */
+	unsigned int now = at91_get_pit_value();
+
+	if (now < pit_last)
+		pit_wraps++;
+	pit_last = now;
+
+	return ((unsigned long long)pit_wraps << 32) | now;
+}
+
+static unsigned long long pit_ticks_to_us(unsigned long long ticks)
+{
+	unsigned int mult = PIT_US_MULT;
+
 	if (pmc_mck_check_h32mxdiv())
-		delay = (((MASTER_CLOCK / 2) >> 10) * usec) >> 14;
-	else
-		delay = ((MASTER_CLOCK >> 10) * usec) >> 14;
-
-	do {
-		current = at91_get_pit_value();
-		current -= base;
-	} while (current < delay);
+		mult <<= 1;
+
+	/* (ticks * mult) >> 32, without a 96-bit product */
+	return (ticks >> 32) * mult
+		+ (((ticks & 0xffffffff) * mult) >> 32);
 }
 
-void mdelay(unsigned int msec)
+unsigned int ticks_to_us(unsigned long long ticks)
+{
+	return (unsigned int)pit_ticks_to_us(ticks);
+}
+
+unsigned long long get_time_us(void)
+{
+	return pit_ticks_to_us(get_ticks());
+}
+
+unsigned long long us_to_ticks(unsigned long long usec)
 {
-	unsigned int base = at91_get_pit_value();
-	unsigned int delay;
-	unsigned int current;
+	unsigned long long ticks = usec * PIT_TICKS_PER_US_Q16;
 
 	if (pmc_mck_check_h32mxdiv())
-		delay = (((MASTER_CLOCK / 2) / 1000) * msec) / 16;
-	else
-		delay = ((MASTER_CLOCK / 1000) * msec) / 16;
-
-	do {
-		current = at91_get_pit_value();
-		current -= base;
-	} while (current < delay);
+		return ticks >> 17;
+
+	return ticks >> 16;
+}
+
+void udelay(unsigned int usec)
+{
+	unsigned long long end = get_ticks() + us_to_ticks(usec);
+
+	/* no background work here, callers may be timing bus slots */
+	while (get_ticks() < end)
+		;
+}
+
+void mdelay(unsigned int msec)
+{
+	unsigned long long end = get_ticks()
+				 + us_to_ticks((unsigned long long)msec * 1000);
+
+	while (get_ticks() < end)
+		idle_poll();
 }
 
 /* Init a special timer for slow clock switch function */
-static int timer1_base;
+static unsigned long long timer1_base;
 
 int start_interval_timer(void)
 {
-	timer1_base = at91_get_pit_value();
+	timer1_base = get_ticks();
 
 	return 0;
 }
 
-/* Because the below statement is used in the function:
- *	((MASTER_CLOCK / 1000) * msec) is used,
- * to our 32-bit system. the argu "msec" maximum value is:
- * supposed "MASTER_CLOCK" is 132M.
- *	(0xffffffff) / 132000 = 32537.
- * So the maximum delay time is 32537 ms.
- */
 int wait_interval_timer(unsigned int msec)
 {
-	unsigned int delay;
-	unsigned int current;
+	unsigned long long end = timer1_base
+				 + us_to_ticks((unsigned long long)msec * 1000);
 
-	if (pmc_mck_check_h32mxdiv())
-		delay = (((MASTER_CLOCK / 2) / 1000) * msec) / 16;
-	else
-		delay = ((MASTER_CLOCK / 1000) * msec) / 16;
-
-	do {
-		current = at91_get_pit_value();
-		current -= timer1_base;
-	} while (current < delay);
+	while (get_ticks() < end)
+		;
 
 	return 0;
 }
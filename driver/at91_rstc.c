@@ -7,6 +7,7 @@
 #include "common.h"
 #include "hardware.h"
 #include "rstc.h"
+#include "usart.h"
 #include "arch/at91_rstc.h"
 
 static inline void rstc_write(unsigned int offset, unsigned int value)
@@ -45,12 +46,38 @@ void rstc_external_reset(void)
 
 void cpu_reset()
 {
+	/* let the reason for the reset reach the console */
+	usart_flush();
+
 	rstc_write(RSTC_RCR, AT91C_RSTC_RCRKEY
 		| AT91C_RSTC_PROCRST	/* Processor Reset */
 		| AT91C_RSTC_PERRST	/* Peripheral Reset */
 		| AT91C_RSTC_EXTRST);	/* External Reset (assert nRST pin) */
 }
 
+unsigned int rstc_get_reset_type(void)
+{
+	return rstc_read(RSTC_RSR) & AT91C_RSTC_RSTTYP;
+}
+
+/*
+ * Watchdog, software and user resets happen with the board powered, so
+ * what the previous boot measured or left in memory still applies. A
+ * general or wake-up reset may follow a power cycle: with VDDBU on a
+ * battery, the main supply coming back is a wake-up reset too.
+ */
+int rstc_is_warm_reset(void)
+{
+	switch (rstc_get_reset_type()) {
+	case AT91C_RSTC_RSTTYP_WATCHDOG:
+	case AT91C_RSTC_RSTTYP_SOFTWARE:
+	case AT91C_RSTC_RSTTYP_USER:
+		return 1;
+	default:
+		return 0;
+	}
+}
+
 void rstc_ddr_rst_deassert(void)
 {
 	unsigned int grstr = rstc_read(RSTC_GRSTR);
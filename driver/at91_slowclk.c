@@ -5,6 +5,7 @@
 #include "hardware.h"
 #include "arch/at91_slowclk.h"
 #include "timer.h"
+#include "task.h"
 #include "backup.h"
 
 #if !defined(CONFIG_SAMA5D4) && !defined(CONFIG_SAMA5D2) \
@@ -14,7 +15,22 @@
 #define SWITCH_TO_OSC32_EXPECTED_SCKCR_VALUE AT91C_SLCKSEL_OSCSEL
 #endif
 
-int slowclk_enable_osc32(void)
+/*
+ * 32768 Hz Startup Time for clock stabilization, about 1s (1300ms), and
+ * 5 slow clock cycles for internal resynchronization after the switch,
+ * ~153 us (5 / 32768)
+ */
+#define OSC32_STARTUP_US	1300000
+#define OSC32_RESYNC_US		153
+
+static int slowclk_osc32_step(struct task *task);
+
+static struct task slowclk_osc32_task = {
+	.name = "osc32",
+	.step = slowclk_osc32_step,
+};
+
+static void slowclk_osc32_enable(void)
 {
 #if !defined(CONFIG_SAMA5D4) && !defined(CONFIG_SAMA5D2) \
 	&& !defined(CONFIG_SAMA7G5) && !defined(CONFIG_SAMA7D65)
@@ -26,28 +42,23 @@ int slowclk_enable_osc32(void)
 	reg = readl(AT91C_BASE_SCKCR);
 	/* Do nothing if aleady set. */
 	if (reg & AT91C_SLCKSEL_OSC32EN)
-		return 0;
+		return;
 	reg |= AT91C_SLCKSEL_OSC32EN;
 	writel(reg, AT91C_BASE_SCKCR);
 #endif
-
-	/* start a internal timer */
-	start_interval_timer();
-
-	return 0;
 }
 
-static void slowclk_wait_osc32_stable(void)
+/*
+ * Enable the oscillator and start the switch to it, which completes in
+ * the background once the oscillator is stable.
+ */
+int slowclk_enable_osc32(void)
 {
-	/* VDDBU keeps feeding oscilator. No need for wait here. */
-	if (backup_resume())
-		return;
+	slowclk_osc32_enable();
 
-	/*
-	 * Wait 32768 Hz Startup Time for clock stabilization (software loop)
-	 * wait about 1s (1300ms)
-	 */
-	wait_interval_timer(1300);
+	task_start(&slowclk_osc32_task);
+
+	return 0;
 }
 
 #if !defined(CONFIG_SAMA5D4) && !defined(CONFIG_SAMA5D2) \
@@ -72,6 +83,7 @@ static void slowclk_disable_rc32(void)
 	&& !defined(CONFIG_SAMA7G5) && !defined(CONFIG_SAMA7D65)
 	*/
 
+/* Returns 1 if the switch was made and the resynchronization is pending */
 static int slowclk_select_osc32(void)
 {
 	unsigned int reg;
@@ -89,35 +101,53 @@ static int slowclk_select_osc32(void)
 	reg |= AT91C_SLCKSEL_OSCSEL;
 	writel(reg, AT91C_BASE_SCKCR);
 
-	/*
-	 * Waiting 5 slow clock cycles for internal resynchronization
-	 * 5 slow clock cycles = ~153 us (5 / 32768)
-	 */
-	udelay(153);
-
-	return 0;
+	return 1;
 }
 
-int slowclk_switch_osc32(void)
-{
-	unsigned int reg = readl(AT91C_BASE_SCKCR);
+#define OSC32_STATE_STARTUP	0
+#define OSC32_STATE_SELECT	1
+#define OSC32_STATE_RESYNC	2
 
-	if (reg == SWITCH_TO_OSC32_EXPECTED_SCKCR_VALUE)
+static int slowclk_osc32_step(struct task *task)
+{
+	switch (task->state) {
+	case OSC32_STATE_STARTUP:
 		/*
 		 * The slowclk configuration register is already set
 		 * correctly: the osc32 is already selected and running.
 		 * Skip the configuration.
 		 */
-		return 0;
-	slowclk_wait_osc32_stable();
+		if (readl(AT91C_BASE_SCKCR) == SWITCH_TO_OSC32_EXPECTED_SCKCR_VALUE)
+			return TASK_DONE;
 
-	slowclk_select_osc32();
+		task->state = OSC32_STATE_SELECT;
 
+		/* VDDBU keeps feeding oscilator. No need for wait here. */
+		if (!backup_resume())
+			return task_sleep(task, OSC32_STARTUP_US);
+		/* fall through */
+
+	case OSC32_STATE_SELECT:
+		task->state = OSC32_STATE_RESYNC;
+		if (slowclk_select_osc32())
+			return task_sleep(task, OSC32_RESYNC_US);
+		/* fall through */
+
+	case OSC32_STATE_RESYNC:
 #if !defined(CONFIG_SAMA5D4) && !defined(CONFIG_SAMA5D2) \
 	&& !defined(CONFIG_SAM9X60) && !defined(CONFIG_SAM9X7) \
 	&& !defined(CONFIG_SAMA7G5) && !defined(CONFIG_SAMA7D65)
-	slowclk_disable_rc32();
+		slowclk_disable_rc32();
 #endif
+		break;
+	}
+
+	return TASK_DONE;
+}
+
+int slowclk_switch_osc32(void)
+{
+	task_wait(&slowclk_osc32_task);
 
 	return 0;
 }
@@ -225,7 +255,7 @@ int slowclk_switch_osc32_bypass(void)
 
 	/* Enable OSC32, as it is needed for power supply of the osc by-pass cell
 	 */
-	slowclk_enable_osc32();
+	slowclk_osc32_enable();
 
 	slowclk_osc32_bypass();
 
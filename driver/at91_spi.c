@@ -12,6 +12,23 @@
 #include "div.h"
 #include "board.h"
 #include "pmc.h"
+#ifdef CONFIG_SPI_DMA
+#include "xdmac.h"
+#endif
+#ifdef CONFIG_CACHES
+#include "l1cache.h"
+#endif
+
+/*
+ * Number of dummy bytes the bulk receive keeps ahead of the data read
+ * back: the whole receive FIFO when there is one, else the transmit
+ * holding register plus the shift register.
+ */
+#ifdef AT91C_SPI_FIFO_SIZE
+#define SPI_BULK_DEPTH		AT91C_SPI_FIFO_SIZE
+#else
+#define SPI_BULK_DEPTH		2
+#endif
 
 static inline unsigned int spi_readl(unsigned int reg)
 {
@@ -23,6 +40,30 @@ static inline void spi_writel(unsigned int reg, unsigned int value)
 	writel(value, CONFIG_SYS_BASE_SPI + reg);
 }
 
+/*
+ * With the FIFO enabled, the width of the access to TDR or RDR is the
+ * number of frames moved: a 32-bit access would queue or pop several
+ * of the 8-bit frames at once. Without it, the registers keep their
+ * 32-bit accesses.
+ */
+static inline void spi_write_tdr(unsigned int value)
+{
+#ifdef AT91C_SPI_FIFO_SIZE
+	writeb(value, CONFIG_SYS_BASE_SPI + SPI_TDR);
+#else
+	spi_writel(SPI_TDR, value);
+#endif
+}
+
+static inline unsigned int spi_read_rdr(void)
+{
+#ifdef AT91C_SPI_FIFO_SIZE
+	return readb(CONFIG_SYS_BASE_SPI + SPI_RDR);
+#else
+	return spi_readl(SPI_RDR);
+#endif
+}
+
 void at91_spi_cs_activate(void)
 {
 	pio_set_value(CONFIG_SYS_SPI_PCS, 0);
@@ -53,6 +94,11 @@ int at91_spi_init(unsigned int pcs, unsigned int clock, unsigned int mode)
 	spi_writel(SPI_CR, AT91C_SPI_SWRST);
 	spi_writel(SPI_CR, AT91C_SPI_SWRST);
 
+#ifdef AT91C_SPI_FIFO_SIZE
+	/* RDRF and TDRE then mean FIFO not empty and FIFO not full */
+	spi_writel(SPI_CR, AT91C_SPI_FIFOEN);
+#endif
+
 	if (pcs == AT91C_SPI_PCS0_DATAFLASH) {
 		ncs = 0;
 	} else if (pcs == AT91C_SPI_PCS1_DATAFLASH) {
@@ -99,7 +145,7 @@ void at91_spi_write_data(unsigned short data)
 {
 	while ((spi_readl(SPI_SR) & AT91C_SPI_TXEMPTY) == 0)
 		;
-	spi_writel(SPI_TDR, data);
+	spi_write_tdr(data);
 	while ((spi_readl(SPI_SR) & AT91C_SPI_TDRE) == 0)
 		;
 }
@@ -108,10 +154,156 @@ unsigned int at91_spi_read_spi(void)
 {
 	while ((spi_readl(SPI_SR) & AT91C_SPI_RDRF) == 0)
 		;
-	return spi_readl(SPI_RDR) & 0xffff;
+	return spi_read_rdr() & 0xffff;
 }
 
 unsigned int at91_spi_read_sr(void)
 {
 	return spi_readl(SPI_SR);
 }
+
+#ifdef CONFIG_SPI_DMA
+/*
+ * The transmit channel feeds the same zero byte over and over to keep
+ * the clock running, the receive channel drains RDR to the buffer.
+ */
+#define SPI_DMA_MIN_LEN		64
+#define SPI_DMA_MAX_DESC	2
+
+static struct xdmac_desc spi_tx_desc[SPI_DMA_MAX_DESC];
+static struct xdmac_desc spi_rx_desc[SPI_DMA_MAX_DESC];
+static const unsigned char spi_dummy_byte;
+
+static int at91_spi_start_dma(struct xdmac_hwcfg *hwcfg,
+			      struct xdmac_desc *desc,
+			      unsigned int incr_daddr,
+			      void *saddr, void *daddr,
+			      unsigned int len)
+{
+	struct xdmac_cfg cfg;
+	struct xdmac_transfer_cfg transfer_cfg;
+
+	cfg.data_width = DMA_DATA_WIDTH_BYTE;
+	cfg.chunk_size = DMA_CHUNK_SIZE_1;
+	cfg.burst_size = DMA_MEM_BURST_16;
+	cfg.incr_saddr = 0;
+	cfg.incr_daddr = incr_daddr;
+
+	transfer_cfg.saddr = saddr;
+	transfer_cfg.daddr = daddr;
+	transfer_cfg.len = len;
+
+	if (xdmac_configure_transfer(hwcfg, &cfg))
+		return -1;
+
+	if (xdmac_prepare_list(desc, SPI_DMA_MAX_DESC, &cfg, &transfer_cfg) < 0)
+		return -1;
+
+	return xdmac_transfer_start_list(hwcfg, desc);
+}
+
+static int at91_spi_read_dma(unsigned char *buf, unsigned int len)
+{
+	struct xdmac_hwcfg tx_hwcfg = {
+		.pid = CONFIG_SYS_ID_SPI,
+		.dst_is_periph = 1,
+		.txif = CONFIG_SYS_SPI_PERID_TX,
+	};
+	struct xdmac_hwcfg rx_hwcfg = {
+		.pid = CONFIG_SYS_ID_SPI,
+		.src_is_periph = 1,
+		.rxif = CONFIG_SYS_SPI_PERID_RX,
+	};
+	int ret;
+
+	if (xdmac_request_channel(&tx_hwcfg))
+		return -1;
+
+	if (xdmac_request_channel(&rx_hwcfg)) {
+		xdmac_transfer_stop(&tx_hwcfg);
+		return -1;
+	}
+
+#ifdef CONFIG_CACHES
+	/* no dirty line may be written back over the DMA data */
+	dcache_clean_region((unsigned int)buf, (unsigned int)buf + len);
+#endif
+
+	/* the receive side must be armed before the first byte is sent */
+	ret = at91_spi_start_dma(&rx_hwcfg, spi_rx_desc, 1,
+				 (void *)(CONFIG_SYS_BASE_SPI + SPI_RDR),
+				 buf, len);
+	if (ret)
+		goto dma_stop;
+
+	ret = at91_spi_start_dma(&tx_hwcfg, spi_tx_desc, 0,
+				 (void *)&spi_dummy_byte,
+				 (void *)(CONFIG_SYS_BASE_SPI + SPI_TDR), len);
+	if (ret)
+		goto dma_stop;
+
+	ret = xdmac_list_wait_for_completion(&tx_hwcfg);
+	if (!ret)
+		ret = xdmac_list_wait_for_completion(&rx_hwcfg);
+
+dma_stop:
+	xdmac_transfer_stop(&tx_hwcfg);
+	xdmac_transfer_stop(&rx_hwcfg);
+
+#ifdef CONFIG_CACHES
+	dcache_invalidate_region((unsigned int)buf, (unsigned int)buf + len);
+#endif
+
+	return ret;
+}
+#endif
+
+/*
+ * Read @len bytes in one go, the chip select being left as it is. The
+ * dummy bytes are queued ahead of the data read back, so the clock does
+ * not stop between the bytes as it does with the write/read pairs.
+ */
+int at91_spi_read_bulk(unsigned char *buf, unsigned int len)
+{
+	unsigned int sent = 0;
+	unsigned int received = 0;
+	unsigned int sr;
+
+#ifdef CONFIG_SPI_DMA
+	if (len >= SPI_DMA_MIN_LEN) {
+		if (!at91_spi_read_dma(buf, len))
+			return 0;
+
+		dbg_info("SPI: DMA read failed\n");
+		return -1;
+	}
+#endif
+
+	while (received < len) {
+		sr = spi_readl(SPI_SR);
+
+		/* a byte was replaced in RDR before it was read */
+		if (sr & AT91C_SPI_OVRES) {
+			dbg_info("SPI: Receive overrun\n");
+
+			/* drop the bytes in flight for the next transfer */
+			while (!(spi_readl(SPI_SR) & AT91C_SPI_TXEMPTY))
+				;
+			while (spi_readl(SPI_SR) & AT91C_SPI_RDRF)
+				spi_read_rdr();
+
+			return -1;
+		}
+
+		if ((sent < len) && (sent - received < SPI_BULK_DEPTH)
+		    && (sr & AT91C_SPI_TDRE)) {
+			spi_write_tdr(0);
+			sent++;
+		}
+
+		if (sr & AT91C_SPI_RDRF)
+			buf[received++] = spi_read_rdr();
+	}
+
+	return 0;
+}
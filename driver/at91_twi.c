@@ -8,6 +8,16 @@
 #include "div.h"
 #include "debug.h"
 #include "pmc.h"
+#include "timer.h"
+#include "twi.h"
+#ifdef CONFIG_TWI_DMA
+#include "common.h"
+#include "flexcom.h"
+#include "xdmac.h"
+#endif
+#ifdef CONFIG_CACHES
+#include "l1cache.h"
+#endif
 
 #if defined(CONFIG_SAMA5D2)
 #define TWI_CLK_OFFSET (3) /* TODO: handle GCK case (offset=0) */
@@ -19,7 +29,15 @@
 #define TWI_CLK_OFFSET (4)
 #endif
 
-#define TWI_CLOCK	400000
+/* FIFO and alternative command mode */
+#if defined(CONFIG_SAMA5D2) || defined(CONFIG_SAM9X60) || \
+	defined(CONFIG_SAM9X7) || defined(CONFIG_SAMA7G5) || \
+	defined(CONFIG_SAMA7D65)
+#define TWI_HAS_FIFO
+#endif
+
+/* SMBus clock low timeout */
+#define TWI_BYTE_TIMEOUT_US	25000
 
 unsigned int twi_init_done;
 
@@ -114,22 +132,48 @@ static void twi_writebyte(unsigned int twi_base, unsigned char byte)
 	twi_reg_write(twi_base, TWI_THR, byte);
 }
 
-static unsigned char twi_check_rxrdy(unsigned int twi_base)
+#ifdef TWI_HAS_FIFO
+/*
+ * With the FIFO enabled, the width of the access to RHR or THR is the
+ * number of bytes moved: a 32-bit write would push four of them.
+ */
+static unsigned char twi_fifo_readbyte(unsigned int twi_base)
 {
-	return ((twi_reg_read(twi_base, TWI_SR) & TWI_SR_RXRDY)
-							== TWI_SR_RXRDY);
+	return readb(twi_base + TWI_RHR);
 }
 
-static unsigned char twi_check_txrdy(unsigned int twi_base)
+static void twi_fifo_writebyte(unsigned int twi_base, unsigned char byte)
 {
-	return ((twi_reg_read(twi_base, TWI_SR) & TWI_SR_TXRDY)
-							== TWI_SR_TXRDY);
+	writeb(byte, twi_base + TWI_THR);
 }
+#endif
 
-static unsigned char twi_check_txcompleted(unsigned int twi_base)
+/*
+ * Wait for @flag in the status register. The slave may stretch SCL
+ * before each byte, so the limit is the SMBus clock low timeout rather
+ * than a loop count, and it starts again for every byte.
+ */
+static int twi_wait(unsigned int twi_base, unsigned int flag)
 {
-	return ((twi_reg_read(twi_base, TWI_SR) & TWI_SR_TXCOMP)
-							== TWI_SR_TXCOMP);
+	unsigned long long deadline = deadline_from_us(TWI_BYTE_TIMEOUT_US);
+	unsigned int status;
+
+	for (;;) {
+		status = twi_reg_read(twi_base, TWI_SR);
+		if (status & (TWI_SR_NACK | TWI_SR_ARBLST)) {
+			dbg_loud("twi: %s\n", (status & TWI_SR_NACK) ?
+				 "not acknowledged" : "arbitration lost");
+			return -1;
+		}
+
+		if (status & flag)
+			return 0;
+
+		if (deadline_expired(deadline)) {
+			dbg_loud("twi: timeout to wait SR 0x%x\n", flag);
+			return -1;
+		}
+	}
 }
 
 static void twi_startread(unsigned int twi_base, unsigned char device_addr,
@@ -144,105 +188,337 @@ static void twi_startread(unsigned int twi_base, unsigned char device_addr,
 	twi_reg_write(twi_base, TWI_CR, TWI_CR_START);
 }
 
+/* The transfer starts with the first byte written to THR */
 static void twi_startwrite(unsigned int twi_base, unsigned char device_addr,
-			unsigned int internal_addr, unsigned char iaddr_size,
-			unsigned char byte)
+			unsigned int internal_addr, unsigned char iaddr_size)
 {
 	twi_reg_write(twi_base, TWI_MMR, TWI_MMR_IADRSZ(iaddr_size)
 				| TWI_MMR_MREAD_WR
 				| TWI_MMR_DADR(device_addr));
 
 	twi_reg_write(twi_base, TWI_IADR, internal_addr);
+}
 
-	twi_reg_write(twi_base, TWI_THR, byte);
-};
-
-int twi_read(unsigned int bus, unsigned char device_addr,
-		unsigned int internal_addr, unsigned char iaddr_size,
-		unsigned char *data, unsigned int bytes)
+#ifdef TWI_HAS_FIFO
+/*
+ * Alternative command mode: the controller is given the length up front
+ * and sends the STOP by itself after the last byte, so the data only has
+ * to be moved through the FIFO while the bus keeps running.
+ */
+static int twi_xfer_fifo(unsigned int twi_base, struct twi_msg *msg)
 {
-	int timeout;
-	unsigned int twi_base;
+	unsigned char *data = msg->data;
+	unsigned int bytes = msg->bytes;
+	unsigned int acr = TWI_ACR_DATAL(bytes);
 
-	twi_base = get_twi_base(bus);
-	if (!twi_base) {
-		dbg_loud("%s: the base address is NULL\n", __func__);
-		return -1;
+	twi_reg_write(twi_base, TWI_CR, TWI_CR_FIFOEN | TWI_CR_ACMEN);
+	twi_reg_write(twi_base, TWI_CR, TWI_CR_THRCLR | TWI_CR_RHRCLR);
+
+	if (msg->flags & TWI_MSG_READ) {
+		acr |= TWI_ACR_DIR;
+		twi_reg_write(twi_base, TWI_ACR, acr);
+		twi_startread(twi_base, msg->device_addr,
+			      msg->internal_addr, msg->iaddr_size);
+
+		while (bytes--) {
+			if (twi_wait(twi_base, TWI_SR_RXRDY))
+				goto err;
+
+			*data++ = twi_fifo_readbyte(twi_base);
+		}
+	} else {
+		twi_reg_write(twi_base, TWI_ACR, acr);
+		twi_startwrite(twi_base, msg->device_addr, msg->internal_addr,
+			       msg->iaddr_size);
+		twi_fifo_writebyte(twi_base, *data++);
+
+		while (--bytes) {
+			if (twi_wait(twi_base, TWI_SR_TXRDY))
+				goto err;
+
+			twi_fifo_writebyte(twi_base, *data++);
+		}
 	}
 
-	twi_startread(twi_base, device_addr, internal_addr, iaddr_size);
+	if (twi_wait(twi_base, TWI_SR_TXCOMP))
+		goto err;
+
+	return 0;
+
+err:
+	/* drop the bytes left behind and release the lock set on NACK */
+	twi_reg_write(twi_base, TWI_CR, TWI_CR_THRCLR | TWI_CR_LOCKCLR);
+
+	return -1;
+}
+#endif
+
+#ifdef CONFIG_TWI_DMA
+/*
+ * Shorter messages are done faster by the CPU than by setting up a
+ * channel.
+ */
+#define TWI_DMA_MIN_LEN		16
+
+static const struct {
+	unsigned int base;
+	unsigned int txif;
+	unsigned int rxif;
+} twi_dma_perids[] = {
+	{ AT91C_BASE_TWI0,
+	  AT91C_XDMAC_PERID_TWI0_TX, AT91C_XDMAC_PERID_TWI0_RX },
+	{ AT91C_BASE_TWI1,
+	  AT91C_XDMAC_PERID_TWI1_TX, AT91C_XDMAC_PERID_TWI1_RX },
+	{ AT91C_BASE_FLEXCOM0 + AT91C_OFFSET_FLEXCOM_TWI,
+	  AT91C_XDMAC_PERID_FLEXCOM0_TX, AT91C_XDMAC_PERID_FLEXCOM0_RX },
+	{ AT91C_BASE_FLEXCOM1 + AT91C_OFFSET_FLEXCOM_TWI,
+	  AT91C_XDMAC_PERID_FLEXCOM1_TX, AT91C_XDMAC_PERID_FLEXCOM1_RX },
+	{ AT91C_BASE_FLEXCOM2 + AT91C_OFFSET_FLEXCOM_TWI,
+	  AT91C_XDMAC_PERID_FLEXCOM2_TX, AT91C_XDMAC_PERID_FLEXCOM2_RX },
+	{ AT91C_BASE_FLEXCOM3 + AT91C_OFFSET_FLEXCOM_TWI,
+	  AT91C_XDMAC_PERID_FLEXCOM3_TX, AT91C_XDMAC_PERID_FLEXCOM3_RX },
+	{ AT91C_BASE_FLEXCOM4 + AT91C_OFFSET_FLEXCOM_TWI,
+	  AT91C_XDMAC_PERID_FLEXCOM4_TX, AT91C_XDMAC_PERID_FLEXCOM4_RX },
+};
+
+/*
+ * Wait for the channel to move the whole message, and end the wait
+ * early when the slave does not acknowledge since the FIFO then stops
+ * requesting data.
+ */
+static int twi_dma_wait(unsigned int twi_base, struct xdmac_hwcfg *hwcfg,
+			unsigned int bytes)
+{
+	unsigned long long deadline;
+	unsigned int status;
+	int ret;
 
-	while (bytes > 0) {
-		if (bytes == 1)
-			twi_stop(twi_base);
+	deadline = deadline_from_us(bytes * TWI_BYTE_TIMEOUT_US);
 
-		timeout = 10000;
-		while (!twi_check_rxrdy(twi_base) && (--timeout))
-			;
+	for (;;) {
+		ret = xdmac_transfer_poll(hwcfg);
+		if (ret)
+			return (ret < 0) ? -1 : 0;
 
-		if (!timeout) {
-			dbg_loud("twi read: timeout to wait RXRDY bit on bus %u\n", bus);
+		status = twi_reg_read(twi_base, TWI_SR);
+		if (status & (TWI_SR_NACK | TWI_SR_ARBLST)) {
+			dbg_loud("twi: %s\n", (status & TWI_SR_NACK) ?
+				 "not acknowledged" : "arbitration lost");
 			return -1;
 		}
 
-		*data++ = twi_readbyte(twi_base);
-		bytes--;
+		if (deadline_expired(deadline)) {
+			dbg_loud("twi: DMA timeout\n");
+			return -1;
+		}
 	}
+}
 
-	timeout = 10000;
-	while (!twi_check_txcompleted(twi_base) && (--timeout))
-		;
-	if (!timeout) {
-		dbg_loud("twi read: timeout to wait TXCOMP bit\n");
-		return -1;
+/*
+ * Alternative command mode as twi_xfer_fifo(), with an XDMAC channel
+ * moving the bytes one at a time between memory and the FIFO. Without
+ * a free channel the message is done by the CPU.
+ */
+static int twi_xfer_dma(unsigned int twi_base, struct twi_msg *msg)
+{
+	struct xdmac_hwcfg hwcfg = { 0 };
+	struct xdmac_cfg cfg;
+	struct xdmac_transfer_cfg transfer_cfg;
+	unsigned int acr = TWI_ACR_DATAL(msg->bytes);
+	unsigned int i;
+	int ret;
+
+	for (i = 0; i < ARRAY_SIZE(twi_dma_perids); i++)
+		if (twi_dma_perids[i].base == twi_base)
+			break;
+
+	if (i == ARRAY_SIZE(twi_dma_perids))
+		return twi_xfer_fifo(twi_base, msg);
+
+	cfg.data_width = DMA_DATA_WIDTH_BYTE;
+	cfg.chunk_size = DMA_CHUNK_SIZE_1;
+	cfg.burst_size = DMA_MEM_BURST_16;
+	transfer_cfg.len = msg->bytes;
+
+	if (msg->flags & TWI_MSG_READ) {
+		hwcfg.src_is_periph = 1;
+		hwcfg.rxif = twi_dma_perids[i].rxif;
+		cfg.incr_saddr = 0;
+		cfg.incr_daddr = 1;
+		transfer_cfg.saddr = (void *)(twi_base + TWI_RHR);
+		transfer_cfg.daddr = msg->data;
+		acr |= TWI_ACR_DIR;
+	} else {
+		hwcfg.dst_is_periph = 1;
+		hwcfg.txif = twi_dma_perids[i].txif;
+		cfg.incr_saddr = 1;
+		cfg.incr_daddr = 0;
+		transfer_cfg.saddr = msg->data;
+		transfer_cfg.daddr = (void *)(twi_base + TWI_THR);
 	}
 
-	return 0;
+	if (xdmac_request_channel(&hwcfg))
+		return twi_xfer_fifo(twi_base, msg);
+
+	if (xdmac_configure_transfer(&hwcfg, &cfg)) {
+		xdmac_transfer_stop(&hwcfg);
+		return twi_xfer_fifo(twi_base, msg);
+	}
+
+#ifdef CONFIG_CACHES
+	/* the data to send must be in memory, no dirty line over the read */
+	dcache_clean_region((unsigned int)msg->data,
+			    (unsigned int)msg->data + msg->bytes);
+#endif
+
+	twi_reg_write(twi_base, TWI_CR, TWI_CR_FIFOEN | TWI_CR_ACMEN);
+	twi_reg_write(twi_base, TWI_CR, TWI_CR_THRCLR | TWI_CR_RHRCLR);
+	twi_reg_write(twi_base, TWI_ACR, acr);
+
+	/* a read needs the channel armed before START, a write starts it */
+	if (msg->flags & TWI_MSG_READ) {
+		xdmac_transfer_start(&hwcfg, &transfer_cfg);
+		twi_startread(twi_base, msg->device_addr,
+			      msg->internal_addr, msg->iaddr_size);
+	} else {
+		twi_startwrite(twi_base, msg->device_addr,
+			       msg->internal_addr, msg->iaddr_size);
+		xdmac_transfer_start(&hwcfg, &transfer_cfg);
+	}
+
+	ret = twi_dma_wait(twi_base, &hwcfg, msg->bytes);
+	if (!ret)
+		ret = twi_wait(twi_base, TWI_SR_TXCOMP);
+
+	xdmac_transfer_stop(&hwcfg);
+
+	if (ret)
+		twi_reg_write(twi_base, TWI_CR, TWI_CR_THRCLR | TWI_CR_LOCKCLR);
+
+#ifdef CONFIG_CACHES
+	if (msg->flags & TWI_MSG_READ)
+		dcache_invalidate_region((unsigned int)msg->data,
+				(unsigned int)msg->data + msg->bytes);
+#endif
+
+	return ret;
 }
+#endif
 
-int twi_write(unsigned int bus, unsigned char device_addr,
-		unsigned int internal_addr, unsigned char iaddr_size,
-		unsigned char *data, unsigned int bytes)
+/* Byte by byte, with the STOP sent by software */
+static int twi_xfer_single(unsigned int twi_base, struct twi_msg *msg)
 {
-	int timeout;
-	unsigned int twi_base;
+	unsigned char *data = msg->data;
+	unsigned int bytes = msg->bytes;
 
-	twi_base = get_twi_base(bus);
-	if (!twi_base)
-		return -1;
+#ifdef TWI_HAS_FIFO
+	twi_reg_write(twi_base, TWI_CR, TWI_CR_FIFODIS | TWI_CR_ACMDIS);
+#endif
 
-	twi_startwrite(twi_base, device_addr,
-				internal_addr, iaddr_size, *data++);
-	bytes--;
+	if (msg->flags & TWI_MSG_READ) {
+		twi_startread(twi_base, msg->device_addr,
+			      msg->internal_addr, msg->iaddr_size);
 
-	while (bytes > 0) {
-		timeout = 10000;
-		while (!twi_check_txrdy(twi_base) && (--timeout))
-			;
+		while (bytes > 0) {
+			if (bytes == 1)
+				twi_stop(twi_base);
 
-		if (!timeout) {
-			dbg_loud("twi write: timeout to wait TXRDY bit\n");
-			return -1;
-		}
+			if (twi_wait(twi_base, TWI_SR_RXRDY))
+				return -1;
 
+			*data++ = twi_readbyte(twi_base);
+			bytes--;
+		}
+	} else {
+		twi_startwrite(twi_base, msg->device_addr, msg->internal_addr,
+			       msg->iaddr_size);
 		twi_writebyte(twi_base, *data++);
 		bytes--;
+
+		while (bytes > 0) {
+			if (twi_wait(twi_base, TWI_SR_TXRDY))
+				return -1;
+
+			twi_writebyte(twi_base, *data++);
+			bytes--;
+		}
+
+		twi_stop(twi_base);
 	}
 
-	twi_stop(twi_base);
+	return twi_wait(twi_base, TWI_SR_TXCOMP);
+}
 
+int twi_transfer(unsigned int bus, struct twi_msg *msgs, unsigned int count)
+{
+	unsigned int twi_base;
+	int ret;
 
-	timeout = 10000;
-	while (!twi_check_txcompleted(twi_base) && (--timeout))
-		;
-	if (!timeout) {
-		dbg_loud("twi write: timeout to wait TXCOMP bit\n");
+	twi_base = get_twi_base(bus);
+	if (!twi_base) {
+		dbg_loud("%s: the base address is NULL\n", __func__);
 		return -1;
 	}
 
+	for (; count > 0; count--, msgs++) {
+		if (!msgs->bytes)
+			return -1;
+
+#ifdef CONFIG_TWI_DMA
+		if (msgs->bytes >= TWI_DMA_MIN_LEN &&
+		    msgs->bytes <= TWI_ACR_DATAL_MAX)
+			ret = twi_xfer_dma(twi_base, msgs);
+		else
+#endif
+#ifdef TWI_HAS_FIFO
+		if (msgs->bytes <= TWI_ACR_DATAL_MAX)
+			ret = twi_xfer_fifo(twi_base, msgs);
+		else
+#endif
+			ret = twi_xfer_single(twi_base, msgs);
+
+		if (ret) {
+			dbg_loud("twi %s: device 0x%x failed on bus %u\n",
+				 (msgs->flags & TWI_MSG_READ) ? "read" : "write",
+				 msgs->device_addr, bus);
+			return ret;
+		}
+	}
+
 	return 0;
 }
 
+int twi_read(unsigned int bus, unsigned char device_addr,
+		unsigned int internal_addr, unsigned char iaddr_size,
+		unsigned char *data, unsigned int bytes)
+{
+	struct twi_msg msg = {
+		.device_addr = device_addr,
+		.iaddr_size = iaddr_size,
+		.flags = TWI_MSG_READ,
+		.internal_addr = internal_addr,
+		.data = data,
+		.bytes = bytes,
+	};
+
+	return twi_transfer(bus, &msg, 1);
+}
+
+int twi_write(unsigned int bus, unsigned char device_addr,
+		unsigned int internal_addr, unsigned char iaddr_size,
+		unsigned char *data, unsigned int bytes)
+{
+	struct twi_msg msg = {
+		.device_addr = device_addr,
+		.iaddr_size = iaddr_size,
+		.internal_addr = internal_addr,
+		.data = data,
+		.bytes = bytes,
+	};
+
+	return twi_transfer(bus, &msg, 1);
+}
+
 int twi_bus_init(unsigned int (*at91_twi_hw_init)(unsigned int index), unsigned int index)
 {
 	unsigned int bus_clock = at91_get_ahb_clock();
@@ -253,7 +529,7 @@ int twi_bus_init(unsigned int (*at91_twi_hw_init)(unsigned int index), unsigned
 	if (bus < 0)
 		return bus;
 
-	twi_configure_master_mode(bus, bus_clock, TWI_CLOCK);
+	twi_configure_master_mode(bus, bus_clock, CONFIG_TWI_CLOCK);
 
 	twi_init_done = 1;
 
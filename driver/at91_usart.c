@@ -5,6 +5,8 @@
 #include "hardware.h"
 #include "board.h"
 #include "arch/at91_dbgu.h"
+#include "usart.h"
+#include "idle.h"
 
 #ifdef CONFIG_USART
 
@@ -25,8 +27,100 @@ static inline unsigned int read_usart(unsigned int offset)
 	return readl(offset + USART_BASE);
 }
 
+/*
+ * The FLEXCOM USART consoles can take a burst of chars at once. Their
+ * FIFO is only worth it with the buffered output, which feeds it.
+ */
+#if defined(CONFIG_CONSOLE_BUFFER) && \
+	(defined(CONFIG_SAMA7G5) || defined(CONFIG_SAMA7D65))
+#define USART_HAS_FIFO
+#endif
+
+/*
+ * With the FIFO enabled, the width of the access to THR or RHR is the
+ * number of chars moved: a 32-bit write would push three NULs after
+ * each char.
+ */
+static inline void write_usart_char(const char c)
+{
+#ifdef USART_HAS_FIFO
+	writeb(c, DBGU_THR + USART_BASE);
+#else
+	write_usart(DBGU_THR, c);
+#endif
+}
+
+static inline char read_usart_char(void)
+{
+#ifdef USART_HAS_FIFO
+	return (char)readb(DBGU_RHR + USART_BASE);
+#else
+	return (char)read_usart(DBGU_RHR);
+#endif
+}
+
+#ifdef CONFIG_CONSOLE_BUFFER
+/*
+ * Output is queued here and sent whenever the transmitter has room: from
+ * the idle hook, run by the timer waits, and from usart_puts() itself.
+ * Only a full buffer or usart_flush() make the CPU wait for the line.
+ */
+#define USART_BUFFER_SIZE	CONFIG_CONSOLE_BUFFER_SIZE
+
+static char usart_buffer[USART_BUFFER_SIZE];
+static unsigned int usart_head;		/* next slot to fill */
+static unsigned int usart_tail;		/* next char to send */
+static unsigned int usart_ready;
+
+/* Move as many queued chars to the transmitter as it accepts right now */
+static void usart_drain(void)
+{
+	while (usart_tail != usart_head &&
+	       (read_usart(DBGU_CSR) & AT91C_DBGU_TXRDY)) {
+		write_usart_char(usart_buffer[usart_tail]);
+		if (++usart_tail == USART_BUFFER_SIZE)
+			usart_tail = 0;
+	}
+}
+
+void usart_flush(void)
+{
+	if (!usart_ready)
+		return;
+
+	while (usart_tail != usart_head)
+		usart_drain();
+
+	while (!(read_usart(DBGU_CSR) & AT91C_DBGU_TXEMPTY))
+		;
+}
+
+static void usart_putc(const char c)
+{
+	unsigned int next = usart_head + 1;
+
+	if (next == USART_BUFFER_SIZE)
+		next = 0;
+
+	/* full: give the line the time it needs to free one slot */
+	while (next == usart_tail) {
+		if (!usart_ready)
+			return;
+		usart_drain();
+	}
+
+	usart_buffer[usart_head] = c;
+	usart_head = next;
+}
+#endif
+
 void usart_init(unsigned int baudrate)
 {
+#ifdef CONFIG_CONSOLE_BUFFER
+	/* the reset below would drop what is still in flight */
+	usart_flush();
+#endif
+
 	/* Disable interrupts */
 	write_usart(DBGU_IDR, -1);
 
@@ -45,17 +139,29 @@ void usart_init(unsigned int baudrate)
 				| AT91C_DBGU_CHRL_8BIT
 				| AT91C_DBGU_NBSTOP_1BIT);
 
+#ifdef USART_HAS_FIFO
+	write_usart(DBGU_CR, AT91C_US_FIFOEN);
+#endif
+
 	/* Enable RX and Tx */
 	write_usart(DBGU_CR, AT91C_DBGU_RXEN | AT91C_DBGU_TXEN);
+
+#ifdef CONFIG_CONSOLE_BUFFER
+	usart_ready = 1;
+	usart_drain();
+	idle_set_hook(usart_drain);
+#endif
 }
 
+#ifndef CONFIG_CONSOLE_BUFFER
 static void usart_putc(const char c)
 {
 	while (!(read_usart(DBGU_CSR) & AT91C_DBGU_TXRDY))
 		;
 
-	write_usart(DBGU_THR, c);
+	write_usart_char(c);
 }
+#endif
 
 void usart_puts(const char *ptr)
 {
@@ -67,6 +173,11 @@ void usart_puts(const char *ptr)
 		usart_putc(ptr[i]);
 		i++;
 	}
+
+#ifdef CONFIG_CONSOLE_BUFFER
+	if (usart_ready)
+		usart_drain();
+#endif
 }
 
 char usart_getc(void)
@@ -74,7 +185,7 @@ char usart_getc(void)
 	while (!(read_usart(DBGU_CSR) & AT91C_DBGU_RXRDY))
 		;
 
-	return (char)read_usart(DBGU_RHR);
+	return read_usart_char();
 }
 
 #else
@@ -7,6 +7,27 @@
 #include "arch/at91_xdmac.h"
 #include "xdmac.h"
 #include "pmc.h"
+#include "timer.h"
+#include "debug.h"
+#ifdef CONFIG_CACHES
+#include "l1cache.h"
+#endif
+
+/*
+ * Longest wait for a transfer. The longest ones, AES passes over a whole
+ * image of some MB, stay well below it.
+ */
+#define XDMAC_TIMEOUT_US	5000000
+
+/* The channel IDs fit in the bit masks of the global registers */
+#define XDMAC_MAX_CHANNELS	32
+
+/* channels handed out by xdmac_request_channel() */
+static unsigned int xdmac_allocated;
+/* channels running a linked list rather than a single block */
+static unsigned int xdmac_list_mode;
+/* channel interrupt status gathered since the transfer was started */
+static unsigned int xdmac_status[XDMAC_MAX_CHANNELS];
 
 static inline unsigned int xdmac_readl(unsigned int reg)
 {
@@ -18,19 +39,42 @@ static inline void xdmac_writel(unsigned int reg, unsigned int value)
 	writel(value, CONFIG_SYS_BASE_XDMAC + reg);
 }
 
-int xdmac_configure_transfer(struct xdmac_hwcfg *hwcfg, struct xdmac_cfg *cfg)
+/*
+ * Hand out a channel no other caller is using and store it in
+ * hwcfg->cid. The controller clock stays on until the last channel is
+ * given back by xdmac_transfer_stop().
+ */
+int xdmac_request_channel(struct xdmac_hwcfg *hwcfg)
 {
-	unsigned int cc_cfg;
-	unsigned int reg, mask;
-
-	cc_cfg = 0;
-	mask = (1 << hwcfg->cid);
+	unsigned int num_channels;
+	unsigned int busy;
+	unsigned int cid;
 
 	pmc_enable_periph_clock(CONFIG_SYS_ID_XDMAC, PMC_PERIPH_CLK_DIVIDER_NA);
-	/* The DMA channel should be disabled. */
-	reg = xdmac_readl(XDMAC_GS);
-	if (reg & mask)
-		return -1;
+
+	num_channels = XDMAC_GTYPE_NB_CH(xdmac_readl(XDMAC_GTYPE));
+	if (num_channels > XDMAC_MAX_CHANNELS)
+		num_channels = XDMAC_MAX_CHANNELS;
+
+	busy = xdmac_allocated | xdmac_readl(XDMAC_GS);
+	for (cid = 0; cid < num_channels; cid++) {
+		if (!(busy & (1 << cid))) {
+			xdmac_allocated |= (1 << cid);
+			hwcfg->cid = cid;
+			return 0;
+		}
+	}
+
+	if (!xdmac_allocated)
+		pmc_disable_periph_clock(CONFIG_SYS_ID_XDMAC);
+
+	return -1;
+}
+
+static unsigned int xdmac_channel_config(struct xdmac_hwcfg *hwcfg,
+					 struct xdmac_cfg *cfg)
+{
+	unsigned int cc_cfg;
 
 	if (hwcfg->src_is_periph || hwcfg->dst_is_periph) {
 		cc_cfg = XDMAC_CC_TYPE_PER_TRAN;
@@ -56,49 +100,286 @@ int xdmac_configure_transfer(struct xdmac_hwcfg *hwcfg, struct xdmac_cfg *cfg)
 		cc_cfg |= XDMAC_CC_SAM_INCREMENTED_AM;
 	if (cfg->incr_daddr)
 		cc_cfg |= XDMAC_CC_DAM_INCREMENTED_AM;
-	xdmac_writel(XDMAC_CHAN(hwcfg->cid) + XDMAC_CC, cc_cfg);
-	return 0;
+
+	return cc_cfg;
 }
 
-int xdmac_transfer_wait_for_completion(struct xdmac_hwcfg *hwcfg)
+int xdmac_configure_transfer(struct xdmac_hwcfg *hwcfg, struct xdmac_cfg *cfg)
 {
-	unsigned int cis;
+	unsigned int reg, mask;
 
-	cis = xdmac_readl(XDMAC_CHAN(hwcfg->cid) + XDMAC_CIS);
-	while (cis == 0)
-		cis = xdmac_readl(XDMAC_CHAN(hwcfg->cid) + XDMAC_CIS);
+	mask = (1 << hwcfg->cid);
 
-	if (cis & (XDMAC_CI_ROE | XDMAC_CI_WBE | XDMAC_CI_RBE))
+	pmc_enable_periph_clock(CONFIG_SYS_ID_XDMAC, PMC_PERIPH_CLK_DIVIDER_NA);
+	/* The DMA channel should be disabled. */
+	reg = xdmac_readl(XDMAC_GS);
+	if (reg & mask)
 		return -1;
-	else if (cis & XDMAC_CI_BI)
-		xdmac_writel(XDMAC_GD, (1 << hwcfg->cid));
+
+	xdmac_writel(XDMAC_CHAN(hwcfg->cid) + XDMAC_CC,
+		     xdmac_channel_config(hwcfg, cfg));
 	return 0;
 }
 
-int xdmac_transfer_start(struct xdmac_hwcfg *hwcfg, struct xdmac_transfer_cfg *cfg)
+static void xdmac_channel_enable(struct xdmac_hwcfg *hwcfg)
 {
-	xdmac_writel(XDMAC_CHAN(hwcfg->cid) + XDMAC_CSA,
-				(unsigned int)cfg->saddr);
-	xdmac_writel(XDMAC_CHAN(hwcfg->cid) + XDMAC_CDA,
-				(unsigned int)cfg->daddr);
-	xdmac_writel(XDMAC_CHAN(hwcfg->cid) + XDMAC_CUBC,
-				XDMAC_CUBC_UBLEN(cfg->len));
-
 	/* Clear pending channel interrupts. */
 	(void)xdmac_readl(XDMAC_CHAN(hwcfg->cid) + XDMAC_CIS);
+	xdmac_status[hwcfg->cid] = 0;
 	/* Set the Channel Interrupt Disable register: disable all interrupts*/
 	xdmac_writel(XDMAC_CHAN(hwcfg->cid) + XDMAC_CID, 0xffffffff);
 	/* Clear channel interrupt status */
 	(void)xdmac_readl(XDMAC_GIS);
 	/* Set the Global Channel Enable register. */
 	xdmac_writel(XDMAC_GE, 1 << hwcfg->cid);
+}
+
+/*
+ * Start a single block transfer of cfg->len data width units. The call
+ * returns at once, the end of the transfer is checked for with
+ * xdmac_transfer_poll() or waited for.
+ */
+int xdmac_transfer_start(struct xdmac_hwcfg *hwcfg, struct xdmac_transfer_cfg *cfg)
+{
+	xdmac_writel(XDMAC_CHAN(hwcfg->cid) + XDMAC_CSA,
+				(unsigned int)cfg->saddr);
+	xdmac_writel(XDMAC_CHAN(hwcfg->cid) + XDMAC_CDA,
+				(unsigned int)cfg->daddr);
+	xdmac_writel(XDMAC_CHAN(hwcfg->cid) + XDMAC_CUBC,
+				XDMAC_CUBC_UBLEN(cfg->len));
+
+	xdmac_list_mode &= ~(1 << hwcfg->cid);
+	xdmac_channel_enable(hwcfg);
+	return 0;
+}
+
+/*
+ * Check a started transfer without blocking: 0 while it runs, 1 once it
+ * is over, the channel being disabled then, and -1 on a bus error.
+ */
+int xdmac_transfer_poll(struct xdmac_hwcfg *hwcfg)
+{
+	unsigned int mask = (1 << hwcfg->cid);
+	unsigned int cis;
+
+	/* reading CIS clears it, keep what was seen for the next poll */
+	cis = xdmac_readl(XDMAC_CHAN(hwcfg->cid) + XDMAC_CIS);
+	cis |= xdmac_status[hwcfg->cid];
+	xdmac_status[hwcfg->cid] = cis;
+
+	if (cis & (XDMAC_CI_ROE | XDMAC_CI_WBE | XDMAC_CI_RBE))
+		return -1;
+
+	/* each block of a list sets BI, only the last one sets LI */
+	if (xdmac_list_mode & mask) {
+		if (!(cis & XDMAC_CI_LI) && (xdmac_readl(XDMAC_GS) & mask))
+			return 0;
+	} else if (!(cis & XDMAC_CI_BI)) {
+		return 0;
+	}
+
+	xdmac_writel(XDMAC_GD, mask);
+	return 1;
+}
+
+int xdmac_transfer_wait_for_completion(struct xdmac_hwcfg *hwcfg)
+{
+	unsigned long long deadline = deadline_from_us(XDMAC_TIMEOUT_US);
+	int ret;
+
+	do {
+		ret = xdmac_transfer_poll(hwcfg);
+		if (!ret && deadline_expired(deadline)) {
+			dbg_info("XDMAC: channel %d timed out\n", hwcfg->cid);
+			return -1;
+		}
+	} while (!ret);
+
+	return (ret < 0) ? -1 : 0;
+}
+
+static int xdmac_list_length(unsigned int remain, unsigned int chunk_size)
+{
+	unsigned int max_len;
+
+	max_len = XDMAC_MBR_UBC_UBLEN_MASK & ~((1 << chunk_size) - 1);
+
+	return (remain > max_len) ? max_len : remain;
+}
+
+/*
+ * Split a transfer of cfg->len bytes into a chain of view 1 descriptors,
+ * each one within the microblock length limit and a whole number of
+ * chunks long. The descriptors must stay in memory the XDMAC reads
+ * coherently until the transfer is over. Returns the number of
+ * descriptors used, -1 if there are not enough of them.
+ */
+int xdmac_prepare_list(struct xdmac_desc *desc, unsigned int num_desc,
+		       struct xdmac_cfg *cfg, struct xdmac_transfer_cfg *transfer_cfg)
+{
+	unsigned int saddr = (unsigned int)transfer_cfg->saddr;
+	unsigned int daddr = (unsigned int)transfer_cfg->daddr;
+	unsigned int remain = transfer_cfg->len >> cfg->data_width;
+	unsigned int len;
+	unsigned int i;
+
+	for (i = 0; remain; i++) {
+		if (i >= num_desc)
+			return -1;
+
+		len = xdmac_list_length(remain, cfg->chunk_size);
+		remain -= len;
+
+		desc[i].mbr_sa = saddr;
+		desc[i].mbr_da = daddr;
+		desc[i].mbr_ubc = XDMAC_MBR_UBC_NVIEW_NDV1 | len;
+		desc[i].mbr_nda = 0;
+		if (remain) {
+			desc[i].mbr_ubc |= XDMAC_MBR_UBC_NDE
+					 | XDMAC_MBR_UBC_NSEN
+					 | XDMAC_MBR_UBC_NDEN;
+			desc[i].mbr_nda = (unsigned int)&desc[i + 1];
+		}
+
+		if (cfg->incr_saddr)
+			saddr += len << cfg->data_width;
+		if (cfg->incr_daddr)
+			daddr += len << cfg->data_width;
+	}
+
+	return i;
+}
+
+/*
+ * Start a view 1 chain on a channel set up by xdmac_configure_transfer().
+ * Like a single transfer, the call does not wait for the end.
+ */
+int xdmac_transfer_start_list(struct xdmac_hwcfg *hwcfg, struct xdmac_desc *desc)
+{
+	xdmac_writel(XDMAC_CHAN(hwcfg->cid) + XDMAC_CNDA,
+		     XDMAC_CNDA_NDA((unsigned int)desc));
+	xdmac_writel(XDMAC_CHAN(hwcfg->cid) + XDMAC_CNDC,
+		     XDMAC_CNDC_NDE | XDMAC_CNDC_NDSUP |
+		     XDMAC_CNDC_NDDUP | XDMAC_CNDC_NDVIEW_NDV1);
+	xdmac_writel(XDMAC_CHAN(hwcfg->cid) + XDMAC_CUBC, 0);
+
+	xdmac_list_mode |= (1 << hwcfg->cid);
+	xdmac_channel_enable(hwcfg);
+	return 0;
+}
+
+/* Wait for the end of the linked list, or for the channel to stop */
+int xdmac_list_wait_for_completion(struct xdmac_hwcfg *hwcfg)
+{
+	return xdmac_transfer_wait_for_completion(hwcfg);
+}
+
+/*
+ * Plan a memory to memory copy with the widest data width the two
+ * addresses can be aligned to together: up to a double word when they
+ * agree modulo 8, down to a byte when one is odd and the other even.
+ * Memory transfers are not split in chunks, so only the burst size
+ * matters beside the width and it is always the largest one.
+ */
+void xdmac_plan_mem_transfer(struct xdmac_plan *plan, struct xdmac_cfg *cfg,
+			     const void *src, void *dst, unsigned int len)
+{
+	unsigned int saddr = (unsigned int)src;
+	unsigned int daddr = (unsigned int)dst;
+	unsigned int width = DMA_DATA_WIDTH_DWORD;
+	unsigned int mask;
+
+	while (width && ((saddr ^ daddr) & ((1 << width) - 1)))
+		width--;
+	mask = (1 << width) - 1;
+
+	plan->head = (0 - daddr) & mask;
+	if (plan->head > len)
+		plan->head = len;
+	plan->len = (len - plan->head) & ~mask;
+	plan->tail = len - plan->head - plan->len;
+
+	cfg->data_width = width;
+	cfg->chunk_size = DMA_CHUNK_SIZE_1;
+	cfg->burst_size = DMA_MEM_BURST_16;
+	cfg->incr_saddr = 1;
+	cfg->incr_daddr = 1;
+}
+
+/*
+ * Copy memory to memory on the channel of @hwcfg, which is left
+ * enabled for the caller to stop. The unaligned head and tail bytes are
+ * copied by the CPU.
+ */
+int xdmac_memcpy(struct xdmac_hwcfg *hwcfg, void *dst, const void *src,
+		 unsigned int len)
+{
+	struct xdmac_plan plan;
+	struct xdmac_cfg cfg;
+	struct xdmac_transfer_cfg transfer_cfg;
+	unsigned char *d = dst;
+	const unsigned char *s = src;
+	unsigned int ublen;
+	unsigned int i;
+	int ret = 0;
+
+	xdmac_plan_mem_transfer(&plan, &cfg, src, dst, len);
+
+	for (i = 0; i < plan.head; i++)
+		*d++ = *s++;
+
+	if (plan.len) {
+		ret = xdmac_configure_transfer(hwcfg, &cfg);
+		if (ret)
+			return ret;
+
+#ifdef CONFIG_CACHES
+		/* no dirty line may be read, or written back over the data */
+		dcache_clean_region((unsigned int)s, (unsigned int)s + plan.len);
+		dcache_clean_region((unsigned int)d, (unsigned int)d + plan.len);
+#endif
+		while (plan.len) {
+			ublen = plan.len >> cfg.data_width;
+			if (ublen > XDMAC_CUBC_UBLEN_MASK)
+				ublen = XDMAC_CUBC_UBLEN_MASK;
+
+			transfer_cfg.saddr = (void *)s;
+			transfer_cfg.daddr = (void *)d;
+			transfer_cfg.len = ublen;
+			xdmac_transfer_start(hwcfg, &transfer_cfg);
+			ret = xdmac_transfer_wait_for_completion(hwcfg);
+			if (ret)
+				break;
+
+			ublen <<= cfg.data_width;
+			s += ublen;
+			d += ublen;
+			plan.len -= ublen;
+		}
+#ifdef CONFIG_CACHES
+		dcache_invalidate_region((unsigned int)dst + plan.head,
+					 (unsigned int)dst + len - plan.tail);
+#endif
+		if (ret)
+			return ret;
+	}
+
+	for (i = 0; i < plan.tail; i++)
+		*d++ = *s++;
+
 	return 0;
 }
 
+/*
+ * Disable the channel and give it back. The controller clock is turned
+ * off once no requested channel is left.
+ */
 void xdmac_transfer_stop(struct xdmac_hwcfg *hwcfg)
 {
 	/* Disable this channel. */
 	xdmac_writel(XDMAC_GD, (1 << hwcfg->cid));
+	xdmac_allocated &= ~(1 << hwcfg->cid);
 	/* Disable XDMAC clock. */
-	pmc_disable_periph_clock(CONFIG_SYS_ID_XDMAC);
+	if (!xdmac_allocated)
+		pmc_disable_periph_clock(CONFIG_SYS_ID_XDMAC);
 }
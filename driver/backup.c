@@ -110,6 +110,7 @@ unsigned long backup_mode_resume(void)
 				);
 #if defined(DEBUG_BKP_SR_INIT)
 		dbg_hexdump((unsigned char *)pm_bu, 16, DUMP_WIDTH_BIT_32);
+		usart_flush();
 		while (1) {};
 #endif
 		cpu_reset();
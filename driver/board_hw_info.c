@@ -9,6 +9,8 @@
 #include "ds24xx.h"
 #include "at24xx.h"
 #include "debug.h"
+#include "rstc.h"
+#include "task.h"
 
 /* Board Type */
 #define BOARD_TYPE_CPU		1
@@ -68,6 +70,13 @@ static unsigned int sn;
 static unsigned int rev;
 static unsigned char buffer[HW_INFO_TOTAL_SIZE];
 
+static int board_hw_info_step(struct task *task);
+
+static struct task board_hw_info_task = {
+	.name = "hw_info",
+	.step = board_hw_info_step,
+};
+
 static struct {
 	char *board_name;
 	unsigned char board_type;
@@ -548,67 +557,109 @@ static unsigned int set_default_rev(void)
 
 unsigned int get_sys_sn(void)
 {
+	task_wait(&board_hw_info_task);
+
 	return sn;
 }
 
 unsigned int get_sys_rev(void)
 {
+	task_wait(&board_hw_info_task);
+
 	return rev;
 }
 
 unsigned int get_cm_sn(void)
 {
+	task_wait(&board_hw_info_task);
+
 	return (sn  >> CM_SN_OFFSET) & SN_MASK;
 }
 
 unsigned int get_cm_vendor(void)
 {
+	task_wait(&board_hw_info_task);
+
 	return (sn >> CM_VENDOR_OFFSET) & VENDOR_MASK;
 }
 
 char get_cm_rev(void)
 {
+	task_wait(&board_hw_info_task);
+
 	return 'A' + ((rev >> CM_REV_OFFSET) & REV_MASK);
 }
 
 unsigned int get_dm_sn(void)
 {
+	task_wait(&board_hw_info_task);
+
 	return (sn >> DM_SN_OFFSET) & SN_MASK;
 }
 
 char get_ek_rev(void)
 {
+	task_wait(&board_hw_info_task);
+
 	return 'A' + ((rev >> EK_REV_OFFSET) & REV_MASK);
 }
 
 unsigned int get_ek_sn(void)
 {
+	task_wait(&board_hw_info_task);
+
 	return (sn  >> EK_SN_OFFSET) & SN_MASK;
 }
 
 #if defined(CONFIG_LOAD_ONE_WIRE)
-static int load_1wire_info(unsigned char *buff, unsigned int size,
-			   unsigned int *psn, unsigned int *prev)
+/*
+ * The 1-Wire chips are searched for and read one per step, so a step
+ * only lasts as long as the bit-banging of one ROM search or one read.
+ */
+#define ONE_WIRE_STATE_START	0
+#define ONE_WIRE_STATE_SEARCH	1
+#define ONE_WIRE_STATE_READ	2
+
+static board_info_t one_wire_info;
+static unsigned int one_wire_chip;
+static unsigned int one_wire_parsing;
+
+/* Returns 1 while there is more to do, then 0 or -1 */
+static int load_1wire_info_step(struct task *task,
+				unsigned char *buff, unsigned int size,
+				unsigned int *psn, unsigned int *prev)
 {
-	board_info_t board_info;
-	board_info_t *bd_info = &board_info;
-	unsigned int count;
-	unsigned int parsing = 0;
-	int i;
+	board_info_t *bd_info = &one_wire_info;
+	unsigned int i;
 
-	memset(bd_info, 0, sizeof(*bd_info));
+	switch (task->state) {
+	case ONE_WIRE_STATE_START:
+		memset(bd_info, 0, sizeof(*bd_info));
+		one_wire_chip = 0;
+		one_wire_parsing = 0;
 
-	dbg_info("1-Wire: Loading 1-Wire information ...\n");
+		dbg_info("1-Wire: Loading 1-Wire information ...\n");
 
-	count = enumerate_all_rom();
-	if (!count) {
-		dbg_info("WARNING: 1-Wire: No 1-Wire chip found\n");
-		return -1;
-	}
+		enumerate_rom_start();
+		task->state = ONE_WIRE_STATE_SEARCH;
+		/* fall through */
 
-	dbg_info("1-Wire: BoardName | [Revid] | VendorName\n");
+	case ONE_WIRE_STATE_SEARCH:
+		if (enumerate_rom_next())
+			return 1;
 
-	for (i = 0; i < count; i++) {
+		if (!enumerate_rom_count()) {
+			dbg_info("WARNING: 1-Wire: No 1-Wire chip found\n");
+			return -1;
+		}
+
+		dbg_info("1-Wire: BoardName | [Revid] | VendorName\n");
+
+		task->state = ONE_WIRE_STATE_READ;
+		return 1;
+
+	case ONE_WIRE_STATE_READ:
+		i = one_wire_chip++;
 		if (ds24xx_read_memory(i, 0, 0, size, buff) < 0) {
 			dbg_info("WARNING: 1-Wire: Failed to read from 1-Wire chip!\n");
 			return -1;
@@ -619,19 +670,17 @@ static int load_1wire_info(unsigned char *buff, unsigned int size,
 		dbg_hexdump(buff, size, DUMP_WIDTH_BIT_8);
 #endif
 
-		if (get_board_hw_info(buff, i, bd_info))
-			continue;
+		if (!get_board_hw_info(buff, i, bd_info) &&
+		    !construct_sn_rev(bd_info, psn, prev))
+			one_wire_parsing++;
 
-		if (construct_sn_rev(bd_info, psn, prev))
-			continue;
+		if (one_wire_chip < enumerate_rom_count())
+			return 1;
 
-		parsing++;
+		return one_wire_parsing ? 0 : -1;
 	}
 
-	if (!parsing)
-		return -1;
-
-	return 0;
+	return -1;
 }
 #endif /* #if defined(CONFIG_LOAD_ONE_WIRE) */
 
@@ -666,17 +715,67 @@ static int load_eeprom_info(unsigned char *buff, unsigned int size,
 }
 #endif /* #if defined(CONFIG_LOAD_EEPROM) */
 
-void load_board_hw_info(void)
+#ifdef CONFIG_BOARD_HW_INFO_CACHE
+/*
+ * The sn and rev words written to the GPBR survive a reset. A tag derived
+ * from them tells the next boot that they are the board's, not defaults
+ * or whatever was left there by someone else.
+ */
+#define HW_INFO_TAG_REG		(AT91C_BASE_GPBR + 4 * CONFIG_BOARD_HW_INFO_CACHE_GPBR)
+#define HW_INFO_TAG_MAGIC	0x48574931	/* "HWI1" */
+
+static unsigned int board_hw_info_tag(unsigned int sn, unsigned int rev)
 {
-	unsigned int size = HW_INFO_TOTAL_SIZE;
-	int ret;
+	/* FNV-1a of the three words */
+	unsigned int tag = 2166136261U;
 
-#if defined(CONFIG_LOAD_ONE_WIRE)
-	ret = load_1wire_info(buffer, size, &sn, &rev);
-#endif
-#if defined(CONFIG_LOAD_EEPROM)
-	ret = load_eeprom_info(buffer, size, 0, &sn, &rev);
+	tag = (tag ^ HW_INFO_TAG_MAGIC) * 16777619;
+	tag = (tag ^ sn) * 16777619;
+
+	return (tag ^ rev) * 16777619;
+}
+
+static int board_hw_info_restore(void)
+{
+	unsigned int saved_sn = readl(AT91C_BASE_GPBR + 4 * 2);
+	unsigned int saved_rev = readl(AT91C_BASE_GPBR + 4 * 3);
+
+	/*
+	 * The boards may have been changed while powered off, and the
+	 * GPBR survive a power cycle when VDDBU is on a battery.
+	 */
+	if (!rstc_is_warm_reset())
+		return -1;
+
+	if (readl(HW_INFO_TAG_REG) != board_hw_info_tag(saved_sn, saved_rev))
+		return -1;
+
+	sn = saved_sn;
+	rev = saved_rev;
+
+	dbg_info("Board sn: %x revision: %x (saved)\n\n", sn, rev);
+
+	return 0;
+}
+
+static void board_hw_info_save(int ret)
+{
+	/* the defaults are not worth keeping, look for the chips next time */
+	writel(ret ? 0 : board_hw_info_tag(sn, rev), HW_INFO_TAG_REG);
+}
+#else
+static int board_hw_info_restore(void)
+{
+	return -1;
+}
+
+static void board_hw_info_save(int ret)
+{
+}
 #endif
+
+static void board_hw_info_done(int ret)
+{
 	if (ret) {
 #if defined(CONFIG_LOAD_ONE_WIRE)
 		dbg_info("\n1-Wire: ");
@@ -694,6 +793,7 @@ void load_board_hw_info(void)
 	writel(sn, AT91C_BASE_GPBR + 4 * 2);
 	writel(rev, AT91C_BASE_GPBR + 4 * 3);
 #endif
+	board_hw_info_save(ret);
 
 #if defined(CONFIG_LOAD_ONE_WIRE)
 	dbg_info("\n1-Wire: ");
@@ -702,6 +802,35 @@ void load_board_hw_info(void)
 	dbg_info("\nEEPROM: ");
 #endif
 	dbg_info("Board sn: %x revision: %x\n\n", sn, rev);
+}
+
+static int board_hw_info_step(struct task *task)
+{
+	unsigned int size = HW_INFO_TOTAL_SIZE;
+	int ret;
+
+	/* first step: nothing to read if the last boot left the result */
+	if (!task->state && !board_hw_info_restore())
+		return TASK_DONE;
+
+#if defined(CONFIG_LOAD_ONE_WIRE)
+	ret = load_1wire_info_step(task, buffer, size, &sn, &rev);
+	if (ret > 0)
+		return task_sleep(task, 0);
+#endif
+#if defined(CONFIG_LOAD_EEPROM)
+	ret = load_eeprom_info(buffer, size, 0, &sn, &rev);
+#endif
+	board_hw_info_done(ret);
 
-	return;
+	return TASK_DONE;
+}
+
+/*
+ * Start reading the board information. It completes in the background,
+ * the accessors above wait for it.
+ */
+void load_board_hw_info(void)
+{
+	task_start(&board_hw_info_task);
 }
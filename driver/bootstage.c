@@ -0,0 +1,96 @@
+// Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+//
+// SPDX-License-Identifier: MIT
+
+#include "common.h"
+#include "bootstage.h"
+#include "timer.h"
+#include "fdt.h"
+#include "string.h"
+#include "debug.h"
+
+static const char *const bootstage_names[BOOTSTAGE_COUNT] = {
+	[BOOTSTAGE_CLOCK]		= "clock",
+	[BOOTSTAGE_DRAM]		= "dram",
+	[BOOTSTAGE_HW_INIT]		= "hw_init",
+	[BOOTSTAGE_BOARD_INFO]		= "board_info",
+	[BOOTSTAGE_MEDIA_INIT]		= "media_init",
+	[BOOTSTAGE_IMAGE_READ]		= "image_read",
+	[BOOTSTAGE_SECURE_CHECK]	= "secure_check",
+	[BOOTSTAGE_FDT_FIXUP]		= "fdt_fixup",
+	[BOOTSTAGE_HANDOFF]		= "handoff",
+};
+
+/* Raw timer ticks, 0 means the stage was never reached */
+static unsigned long long bootstage_ticks[BOOTSTAGE_COUNT];
+
+void bootstage_mark(enum bootstage_id id)
+{
+	unsigned long long ticks = get_ticks();
+
+	if (id >= BOOTSTAGE_COUNT)
+		return;
+
+	/* keep 0 free to flag the unused entries */
+	bootstage_ticks[id] = ticks ? ticks : 1;
+}
+
+void bootstage_report(void)
+{
+	unsigned int us, prev = 0;
+	int i;
+
+	dbg_info("BOOTSTAGE: stage, time (us), delta (us)\n");
+
+	for (i = 0; i < BOOTSTAGE_COUNT; i++) {
+		if (!bootstage_ticks[i])
+			continue;
+
+		us = ticks_to_us(bootstage_ticks[i]);
+		dbg_info("BOOTSTAGE: %s, %u, %u\n",
+			 bootstage_names[i], us, us - prev);
+		prev = us;
+	}
+}
+
+#ifdef CONFIG_OF_LIBFDT
+/*
+ * Export the reached stages under /chosen as two matching arrays:
+ *   at91bootstrap,bootstage-names: string list of the stage names
+ *   at91bootstrap,bootstage-us:    u32 timestamps in microseconds
+ */
+int bootstage_fdt_fixup(void *blob)
+{
+	char names[BOOTSTAGE_COUNT * 16];
+	unsigned int stamps[BOOTSTAGE_COUNT];
+	int nameslen = 0;
+	int count = 0;
+	int len;
+	int ret;
+	int i;
+
+	for (i = 0; i < BOOTSTAGE_COUNT; i++) {
+		if (!bootstage_ticks[i])
+			continue;
+
+		len = strlen(bootstage_names[i]) + 1;
+		if (nameslen + len > sizeof(names))
+			break;
+
+		memcpy(&names[nameslen], bootstage_names[i], len);
+		nameslen += len;
+		stamps[count++] = swap_uint32(ticks_to_us(bootstage_ticks[i]));
+	}
+
+	if (!count)
+		return 0;
+
+	ret = fixup_chosen_property(blob, "at91bootstrap,bootstage-names",
+				    names, nameslen);
+	if (ret)
+		return ret;
+
+	return fixup_chosen_property(blob, "at91bootstrap,bootstage-us",
+				     stamps, count * sizeof(unsigned int));
+}
+#endif
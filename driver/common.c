@@ -9,11 +9,16 @@
 #include "flash.h"
 #include "string.h"
 #include "usart.h"
+#include "idle.h"
 
 #ifdef CONFIG_LOAD_SW
 load_function load_image;
 #endif
 
+#ifdef CONFIG_IDLE_HOOK
+idle_hook_t idle_hook;
+#endif
+
 #ifdef CONFIG_SDCARD
 char filename[FILENAME_BUF_LEN];
 #ifdef CONFIG_OF_LIBFDT
@@ -134,10 +139,12 @@ void load_image_done(int retval)
 	}
 	if (retval == -1) {
 		usart_puts("Failed to load image\n");
+		usart_flush();
 		while(1);
 	}
 	if (retval == -2) {
 		usart_puts("Success to recovery\n");
+		usart_flush();
 		while (1);
 	}
 }
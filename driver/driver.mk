@@ -9,10 +9,12 @@ DRIVERS:=
 DRIVERS_SRC:=driver
 
 COBJS-$(CONFIG_DEBUG)		+= $(DRIVERS_SRC)/debug.o
+COBJS-$(CONFIG_BOOTSTAGE)	+= $(DRIVERS_SRC)/bootstage.o
 
 COBJS-$(CONFIG_CPU_HAS_SCKC)	+= $(DRIVERS_SRC)/at91_slowclk.o
 
 COBJS-y				+= $(DRIVERS_SRC)/common.o
+COBJS-y				+= $(DRIVERS_SRC)/task.o
 COBJS-$(CONFIG_PIO)		+= $(DRIVERS_SRC)/at91_pio.o
 COBJS-$(CONFIG_PMC_COMMON)	+= $(DRIVERS_SRC)/pmc/clk-common.o
 COBJS-$(CONFIG_PMC_PERIPH_CLK_SAM9X5)	+= $(DRIVERS_SRC)/pmc/periph-clk-sam9x5.o
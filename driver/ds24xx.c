@@ -47,6 +47,7 @@
 #define FAMILY_CODE_DS28EC		0x43
 
 static unsigned char device_id_array[MAX_ITEMS][CHIP_ADDR_LEN];
+static unsigned int device_count;
 static unsigned char LastDiscrepancy;
 static unsigned char LastFamilyDiscrepancy;
 static unsigned char LastDeviceFlag;
@@ -352,29 +353,57 @@ void one_wire_hw_init(void)
 #endif
 }
 
-unsigned int enumerate_all_rom(void)
+/*
+ * The ROM search is split in one step per chip, each one a few dozen
+ * time slots long, so that it can be interleaved with other work.
+ */
+void enumerate_rom_start(void)
 {
-	int i;
-	int result;
-	unsigned int cnt = 0;
-
 	dbg_info("1-Wire: ROM Searching ... ");
 	one_wire_hw_init();
 
-	result = ds24xx_find_first();
-	while (result) {
+	device_count = 0;
+}
 
-		/* save device info */
-		for (i = 7; i >= 0; i--)
-			device_id_array[cnt][i] = buf[i];
-		cnt++;
+/* Look for the next chip, returns 0 once they have all been found */
+int enumerate_rom_next(void)
+{
+	int i;
+	int result;
 
+	if (device_count >= MAX_ITEMS)
+		result = 0;
+	else if (!device_count)
+		result = ds24xx_find_first();
+	else
 		result = ds24xx_find_next();
+
+	if (!result) {
+		dbg_info("Done, %d 1-Wire chips found\n\n", device_count);
+		return 0;
 	}
 
-	dbg_info("Done, %d 1-Wire chips found\n\n", cnt);
+	/* save device info */
+	for (i = 7; i >= 0; i--)
+		device_id_array[device_count][i] = buf[i];
+	device_count++;
+
+	return 1;
+}
+
+unsigned int enumerate_rom_count(void)
+{
+	return device_count;
+}
+
+unsigned int enumerate_all_rom(void)
+{
+	enumerate_rom_start();
+
+	while (enumerate_rom_next())
+		;
 
-	return cnt;
+	return device_count;
 }
 
 int ds24xx_read_memory(int chip_index, unsigned char addrh,
@@ -8,6 +8,7 @@
 #include "string.h"
 #include "debug.h"
 #include "fdt.h"
+#include "bootstage.h"
 
 #include "debug.h"
 
@@ -42,6 +43,7 @@ int load_norflash(struct image_info *image)
 	int length = 0;
 
 	norflash_hw_init();
+	bootstage_mark(BOOTSTAGE_MEDIA_INIT);
 
 #if defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
 	length = update_image_length(image->offset, image->dest, KERNEL_IMAGE);
@@ -49,6 +51,7 @@ int load_norflash(struct image_info *image)
 		return -1;
 
 	image->length = length;
+	kernel_placement(image);
 #endif
 
 	dbg_info("FLASH: copy %x bytes from %x to %x\n",
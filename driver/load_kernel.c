@@ -20,6 +20,9 @@
 #include "mon.h"
 #include "tz_utils.h"
 #include "secure.h"
+#include "bootstage.h"
+#include "mmu.h"
+#include "lz4.h"
 
 #include "debug.h"
 
@@ -81,6 +84,11 @@ static int setup_dt_blob(void *blob)
 		return ret;
 #endif
 
+	bootstage_mark(BOOTSTAGE_FDT_FIXUP);
+	ret = bootstage_fdt_fixup(blob);
+	if (ret)
+		return ret;
+
 	return 0;
 }
 #else
@@ -223,9 +231,13 @@ int kernel_size(unsigned char *add)
 	return 0;
 }
 
-static int boot_image_setup(unsigned char *addr, unsigned int *entry)
+void kernel_placement(struct image_info *image)
 {
-	*entry = (unsigned int)addr;
+}
+
+static int boot_image_setup(struct image_info *image, unsigned int *entry)
+{
+	*entry = (unsigned int)image->dest;
 	return 0;
 }
 #else
@@ -247,6 +259,10 @@ struct linux_uimage_header {
 	unsigned char	name[32];
 };
 
+/* uImage comp_type values */
+#define LINUX_UIMAGE_COMP_NONE	0
+#define LINUX_UIMAGE_COMP_LZ4	5
+
 /* Linux zImage Header */
 #define	LINUX_ZIMAGE_MAGIC	0x016f2818
 struct linux_zimage_header {
@@ -279,8 +295,164 @@ int kernel_size(unsigned char *addr)
 	return (int)size;
 }
 
-static int boot_image_setup(unsigned char *addr, unsigned int *entry)
+static unsigned int kernel_dram_end(void)
 {
+#if defined(CONFIG_SDRAM)
+	return AT91C_BASE_DDRCS + get_sdram_size();
+#else
+	return AT91C_BASE_DDRCS + get_ddram_size();
+#endif
+}
+
+/*
+ * What the kernel payload must not be loaded over. Only the start of the
+ * device tree is known before it is loaded.
+ */
+static int kernel_region_free(struct image_info *image,
+			      unsigned int start, unsigned int end)
+{
+#ifdef CONFIG_OF_LIBFDT
+	unsigned int of_dest = (unsigned int)image->of_dest;
+
+	if (of_dest && of_dest >= start && of_dest < end)
+		return 0;
+#else
+	/* the ATAG list set up by setup_boot_params() */
+	if (start < AT91C_BASE_DDRCS + 0x1000 && end > AT91C_BASE_DDRCS + 0x100)
+		return 0;
+#endif
+#ifdef CONFIG_MMU
+	if (start < MMU_TABLE_BASE_ADDR + 0x4000 && end > MMU_TABLE_BASE_ADDR)
+		return 0;
+#endif
+
+	return 1;
+}
+
+/*
+ * Once the loader has read the start of the image to image->dest, move
+ * the destination so that the payload of an uncompressed uImage lands
+ * right at its load address, and boot_image_setup() has nothing to copy.
+ */
+void kernel_placement(struct image_info *image)
+{
+	struct linux_uimage_header *uimage_header
+			= (struct linux_uimage_header *)image->dest;
+	unsigned int start, end;
+
+	if (swap_uint32(uimage_header->magic) != LINUX_UIMAGE_MAGIC ||
+	    uimage_header->comp_type != LINUX_UIMAGE_COMP_NONE)
+		return;
+
+	start = swap_uint32(uimage_header->load)
+		- sizeof(struct linux_uimage_header);
+	end = start + sizeof(struct linux_uimage_header)
+		+ swap_uint32(uimage_header->size);
+
+	if (start == (unsigned int)image->dest)
+		return;
+
+	if (start < AT91C_BASE_DDRCS || end < start ||
+	    end > kernel_dram_end() ||
+	    !kernel_region_free(image, start, end)) {
+		dbg_loud("KERNEL: uImage will be relocated after the load\n");
+		return;
+	}
+
+	image->dest = (unsigned char *)start;
+}
+
+#ifdef CONFIG_LZ4
+/* What setup_dt_blob() may still add to the device tree */
+#define DT_FIXUP_ROOM		0x1000
+
+/* Fail if @dest is in [start, end), else stop @limit at its start */
+static int kernel_room_clip(unsigned int dest, unsigned int start,
+			    unsigned int end, unsigned int *limit)
+{
+	if (dest >= start && dest < end)
+		return -1;
+
+	if (start > dest && start < *limit)
+		*limit = start;
+
+	return 0;
+}
+
+/*
+ * Room for the kernel decompressed at @dest: up to the end of the DRAM,
+ * or to the first region above @dest that must survive it, the
+ * compressed payload at @src, the device tree or the boot parameters.
+ * 0 when @dest itself is not free.
+ */
+static unsigned int kernel_room(struct image_info *image, unsigned int dest,
+				unsigned int src, unsigned int size)
+{
+	unsigned int limit = kernel_dram_end();
+#ifdef CONFIG_OF_LIBFDT
+	unsigned int of_dest = (unsigned int)image->of_dest;
+	unsigned int of_size = 0;
+#endif
+
+	if (dest < AT91C_BASE_DDRCS || dest >= limit)
+		return 0;
+
+	if (kernel_room_clip(dest, src, src + size, &limit))
+		return 0;
+
+#ifdef CONFIG_OF_LIBFDT
+	if (of_dest) {
+		if (!check_dt_blob_valid(image->of_dest))
+			of_size = of_get_dt_total_size(image->of_dest);
+
+		if (kernel_room_clip(dest, of_dest,
+				     of_dest + of_size + DT_FIXUP_ROOM, &limit))
+			return 0;
+	}
+#else
+	if (kernel_room_clip(dest, AT91C_BASE_DDRCS + 0x100,
+			     AT91C_BASE_DDRCS + 0x1000, &limit))
+		return 0;
+#endif
+#ifdef CONFIG_MMU
+	if (kernel_room_clip(dest, MMU_TABLE_BASE_ADDR,
+			     MMU_TABLE_BASE_ADDR + 0x4000, &limit))
+		return 0;
+#endif
+
+	return limit - dest;
+}
+
+/* Decompress the payload straight to its load address */
+static int uimage_decompress_lz4(struct image_info *image, unsigned int dest,
+				 unsigned int src, unsigned int size)
+{
+	unsigned int room;
+
+	room = kernel_room(image, dest, src, size);
+	if (!room) {
+		dbg_info("KERNEL: Load address %x is not free for the LZ4 output\n",
+			 dest);
+		return -1;
+	}
+
+	dbg_info("KERNEL: Decompressing LZ4 image dest=%x, src=%x\n",
+		 dest, src);
+
+	if (lz4_decompress((void *)src, size, (void *)dest, &room)) {
+		dbg_info("KERNEL: LZ4 decompression failed!\n");
+		return -1;
+	}
+
+	dbg_info("KERNEL: %x bytes decompressed from %x\n", room, size);
+
+	return 0;
+}
+#endif
+
+static int boot_image_setup(struct image_info *image, unsigned int *entry)
+{
+	unsigned char *addr = image->dest;
 	struct linux_zimage_header *zimage_header
 			= (struct linux_zimage_header *)addr;
 
@@ -302,23 +474,37 @@ static int boot_image_setup(unsigned char *addr, unsigned int *entry)
 	if (magic == LINUX_UIMAGE_MAGIC) {
 		dbg_info("\nKERNEL: Booting uImage ...\n");
 
-		if (uimage_header->comp_type != 0) {
-			dbg_info("KERNEL: No uImage compression is supported!\n");
-			return -1;
-		}
-
 		size = swap_uint32(uimage_header->size);
 		dest = swap_uint32(uimage_header->load);
 		src = (unsigned int)addr + sizeof(struct linux_uimage_header);
 		*entry = swap_uint32(uimage_header->entry_point);
 
-		dbg_info("KERNEL: Relocating image dest=%x, src=%x\n", dest, src);
+		switch (uimage_header->comp_type) {
+		case LINUX_UIMAGE_COMP_NONE:
+			if (dest == src) {
+				dbg_info("KERNEL: Image loaded in place at %x\n",
+					 dest);
+				return 0;
+			}
 
-		memcpy((void *)dest, (void *)src, size);
+			dbg_info("KERNEL: Relocating image dest=%x, src=%x\n",
+				 dest, src);
 
-		dbg_info("KERNEL: %x bytes relocated\n", size);
+			memcpy((void *)dest, (void *)src, size);
 
-		return 0;
+			dbg_info("KERNEL: %x bytes relocated\n", size);
+			return 0;
+
+#ifdef CONFIG_LZ4
+		case LINUX_UIMAGE_COMP_LZ4:
+			return uimage_decompress_lz4(image, dest, src, size);
+#endif
+
+		default:
+			dbg_info("KERNEL: uImage compression %d is not supported!\n",
+				 uimage_header->comp_type);
+			return -1;
+		}
 	}
 
 	dbg_info("KERNEL: Got unsupported magic!\n"
@@ -356,7 +542,6 @@ __attribute__((weak)) char *board_override_cmd_line(void)
 
 int load_kernel(struct image_info *image)
 {
-	unsigned char *addr;
 	unsigned int entry_point;
 	unsigned int r2;
 	unsigned int mach_type;
@@ -416,6 +601,7 @@ int load_kernel(struct image_info *image)
 	ret = load_kernel_image(image);
 	if (ret)
 		return ret;
+	bootstage_mark(BOOTSTAGE_IMAGE_READ);
 
 #ifdef CONFIG_OVERRIDE_CMDLINE_FROM_EXT_FILE
 	bootargs = board_override_cmd_line_ext(image->cmdline_args);
@@ -425,15 +611,15 @@ int load_kernel(struct image_info *image)
 	if (ret)
 		return ret;
 	image->dest += sizeof(at91_secure_header_t);
+	bootstage_mark(BOOTSTAGE_SECURE_CHECK);
 #endif
 
 #ifdef CONFIG_SCLK
 	slowclk_switch_osc32();
 #endif
 
-	addr = image->dest;
 #if defined(CONFIG_LINUX_IMAGE)
-	ret = boot_image_setup(addr, &entry_point);
+	ret = boot_image_setup(image, &entry_point);
 #endif
 	if (ret)
 		return -1;
@@ -454,8 +640,13 @@ int load_kernel(struct image_info *image)
 	r2 = (unsigned int)(AT91C_BASE_DDRCS + 0x100);
 #endif
 
+	bootstage_mark(BOOTSTAGE_HANDOFF);
+	bootstage_report();
+
 	dbg_info("\nKERNEL: Starting linux kernel ..., machid: %x\n\n",
 							mach_type);
+
+	mmu_caches_disable();
 #if defined(CONFIG_ENTER_NWD)
 	monitor_init();
 
@@ -6,9 +6,15 @@
 #include "string.h"
 #include "mci_media.h"
 #include "timer.h"
+#include "task.h"
+#include "bootstage.h"
 #include "atmel_mci.h"
 #include "sdhc.h"
 #include "debug.h"
+#ifdef CONFIG_SDCARD_PROFILE_CACHE
+#include "hardware.h"
+#include "rstc.h"
+#endif
 
 #define DEFAULT_SD_BLOCK_LEN		512
 
@@ -148,7 +154,8 @@ static int sd_check_operational_condition(struct sd_card *sdcard,
 		if (response & OCR_BUSY_STATUS)
 			break;
 
-		udelay(1000);
+		/* the card powers up on its own, let the boot tasks run */
+		task_delay(1000);
 	};
 
 	if (i == retries)
@@ -788,7 +795,7 @@ static int mmc_verify_operating_condition(struct sd_card *sdcard)
 		if (command->resp[0]  & (0x01 << 31))
 			break;
 
-		udelay(1000);
+		task_delay(1000);
 	};
 
 	if (i == retries)
@@ -1122,6 +1129,11 @@ static int mmc_detect_buswidth(struct sd_card *sdcard)
 	unsigned int i;
 	int ret;
 
+	/* no need to test the bus again for the same card */
+	if (sdcard->known_bus_w &&
+	    !mmc_bus_width_select(sdcard, sdcard->known_bus_w, 0))
+		return 0;
+
 	console_printf("MMC: detecting buswidth...\n");
 
 	for (busw = 8, len = 2; busw != 0; busw -= 4, len--) {
@@ -1233,13 +1245,13 @@ static int sdcard_identification(struct sd_card *sdcard)
 	int timeout;
 	int ret;
 
-	udelay(3000);
+	task_delay(3000);
 
 	ret = sd_cmd_go_idle_state(sdcard);
 	if (ret)
 		return ret;
 
-	udelay(2000);
+	task_delay(2000);
 
 	ret = mmc_verify_operating_condition(sdcard);
 	if (ret == 0) {
@@ -1469,6 +1481,151 @@ static int sd_initialization(struct sd_card *sdcard)
 	return 0;
 }
 
+#ifdef CONFIG_SDCARD_PROFILE_CACHE
+/*
+ * What the full e.MMC initialization learns about the card: the CARD_TYPE
+ * byte of the EXT_CSD and the bus width that passed the bus test. It is
+ * kept across warm resets, bound to the card CID and to the host, and
+ * lets the next boot skip the EXT_CSD read and the bus test. The card
+ * still goes through the same timing switches, each of them verified.
+ */
+#define SDCARD_PROFILE_MAGIC	0x50524f46	/* "PROF" */
+
+#define SDCARD_PROFILE_HS	(1 << 0)
+#define SDCARD_PROFILE_HS200	(1 << 1)
+#define SDCARD_PROFILE_HS400	(1 << 2)
+#define SDCARD_PROFILE_DDR	(1 << 3)
+
+struct sdcard_profile {
+	unsigned int magic;
+	unsigned int key;
+	unsigned int flags;
+	unsigned int bus_width;
+	unsigned int check;
+};
+
+#define SDCARD_PROFILE \
+	((struct sdcard_profile *)CONFIG_SDCARD_PROFILE_CACHE_ADDR)
+
+/* SECUMOD_RAMRDY, SECURAM is not accessible before it is set */
+#define SDCARD_PROFILE_RAMRDY_TIMEOUT_US	10000
+
+static int sdcard_profile_ram_ready(void)
+{
+	unsigned long long deadline =
+		deadline_from_us(SDCARD_PROFILE_RAMRDY_TIMEOUT_US);
+
+	while (!readl(AT91C_BASE_SECUMOD + 0x14)) {
+		if (deadline_expired(deadline)) {
+			dbg_info("MMC: SECURAM not ready\n");
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/* FNV-1a, one word at a time */
+static unsigned int sdcard_profile_hash(const unsigned int *data,
+					unsigned int count,
+					unsigned int hash)
+{
+	while (count--)
+		hash = (hash ^ *data++) * 16777619;
+
+	return hash;
+}
+
+static unsigned int sdcard_profile_key(struct sd_card *sdcard)
+{
+	struct sd_host *host = sdcard->host;
+	unsigned int caps[] = {
+		host->caps_bus_width,
+		host->caps_high_speed,
+		host->caps_uhs,
+		host->caps_ddr,
+		host->caps_max_clock,
+	};
+	unsigned int key;
+
+	key = sdcard_profile_hash(sdcard->reg->cid, 4, 2166136261U);
+
+	return sdcard_profile_hash(caps, ARRAY_SIZE(caps), key);
+}
+
+static unsigned int sdcard_profile_check(struct sdcard_profile *profile)
+{
+	return sdcard_profile_hash(&profile->magic, 4, 2166136261U);
+}
+
+static int sdcard_profile_restore(struct sd_card *sdcard)
+{
+	struct sdcard_profile *profile = SDCARD_PROFILE;
+
+	if (sdcard_profile_ram_ready())
+		return -1;
+
+	/* only reuse a setup found with the card powered since */
+	if (!rstc_is_warm_reset()) {
+		profile->magic = 0;
+		return -1;
+	}
+
+	if (profile->magic != SDCARD_PROFILE_MAGIC ||
+	    profile->key != sdcard_profile_key(sdcard) ||
+	    profile->check != sdcard_profile_check(profile))
+		return -1;
+
+	sdcard->highspeed_card = !!(profile->flags & SDCARD_PROFILE_HS);
+	sdcard->hs200speed_card = !!(profile->flags & SDCARD_PROFILE_HS200);
+	sdcard->hs400speed_card = !!(profile->flags & SDCARD_PROFILE_HS400);
+	sdcard->ddr_support = !!(profile->flags & SDCARD_PROFILE_DDR);
+	sdcard->known_bus_w = profile->bus_width;
+
+	dbg_info("MMC: Card profile restored\n");
+
+	return 0;
+}
+
+static void sdcard_profile_save(struct sd_card *sdcard)
+{
+	struct sdcard_profile *profile = SDCARD_PROFILE;
+
+	if (sdcard_profile_ram_ready())
+		return;
+
+	profile->magic = SDCARD_PROFILE_MAGIC;
+	profile->key = sdcard_profile_key(sdcard);
+	profile->flags = (sdcard->highspeed_card ? SDCARD_PROFILE_HS : 0) |
+			 (sdcard->hs200speed_card ? SDCARD_PROFILE_HS200 : 0) |
+			 (sdcard->hs400speed_card ? SDCARD_PROFILE_HS400 : 0) |
+			 (sdcard->ddr_support ? SDCARD_PROFILE_DDR : 0);
+	profile->bus_width = sdcard->configured_bus_w;
+	profile->check = sdcard_profile_check(profile);
+}
+
+static void sdcard_profile_drop(void)
+{
+	if (sdcard_profile_ram_ready())
+		return;
+
+	SDCARD_PROFILE->magic = 0;
+}
+#else
+static int sdcard_profile_restore(struct sd_card *sdcard)
+{
+	return -1;
+}
+
+static void sdcard_profile_save(struct sd_card *sdcard)
+{
+}
+
+static void sdcard_profile_drop(void)
+{
+}
+#endif
+
 static int mmc_initialization(struct sd_card *sdcard)
 {
 	struct sd_host *host = sdcard->host;
@@ -1513,10 +1670,11 @@ static int mmc_initialization(struct sd_card *sdcard)
         if (ret)
                 return 0;
 
-	ret = mmc_card_identify(sdcard);
-
-	if (ret)
-		return ret;
+	if (sdcard_profile_restore(sdcard)) {
+		ret = mmc_card_identify(sdcard);
+		if (ret)
+			return ret;
+	}
 
 	if (sdcard->hs200speed_card){
 		ret = mmc_select_hs200(sdcard);
@@ -1611,9 +1769,22 @@ int sdcard_initialize(void)
 		ret = sd_initialization(sdcard);
 	else
 		ret = mmc_initialization(sdcard);
+
+	if (ret && sdcard->known_bus_w) {
+		/* start over without the saved profile */
+		dbg_info("MMC: Card profile rejected\n");
+		sdcard_profile_drop();
+
+		return sdcard_initialize();
+	}
 	if (ret)
 		return ret;
 
+	if (sdcard->card_type == CARD_TYPE_MMC)
+		sdcard_profile_save(sdcard);
+
+	bootstage_mark(BOOTSTAGE_MEDIA_INIT);
+
 	return 0;
 }
 
@@ -1728,7 +1899,7 @@ static int sd_cmd_read_single_block(struct sd_card *sdcard,
 	return 1;
 }
 
-#define SUPPORT_MAX_BLOCKS	(ADMA2_MAX_NUM_DESC * ADMA2_MAX_DESC_BLOCKS)
+#define SUPPORT_MAX_BLOCKS	SD_MAX_BLOCK_COUNT
 
 unsigned int sdcard_block_read(unsigned int start,
 				unsigned int block_count,
@@ -197,6 +197,12 @@ unsigned int mcp16502_regulator_get_enable(unsigned int regid)
 int mcp16502_init(int busid, int addr, const struct pio_desc *lpm_desc,
 		  const struct mcp16502_cfg *cfgs, unsigned int cfgs_no)
 {
+	struct twi_msg msgs[MCP16502_MAX + 1];
+	unsigned char vals[MCP16502_MAX + 1];
+	unsigned char selector[MCP16502_MAX + 1];
+	unsigned char enable[MCP16502_MAX + 1];
+	unsigned int used = 0;
+	unsigned int regid, count;
 	int i, ret;
 
 	if (busid < 0 || addr < 0)
@@ -209,29 +215,83 @@ int mcp16502_init(int busid, int addr, const struct pio_desc *lpm_desc,
 	if (lpm_desc)
 		pio_configure(lpm_desc);
 
-	/* Setup regulators. */
 	for (i = 0; i < cfgs_no && cfgs; i++) {
 		if (!cfgs[i].uV)
 			continue;
 
-		ret = mcp16502_regulator_set_voltage(cfgs[i].regulator,
-						     cfgs[i].uV);
-		if (ret) {
+		regid = cfgs[i].regulator;
+		if (regid < MCP16502_MIN || regid > MCP16502_MAX ||
+		    cfgs[i].uV < regulators[regid].min_uV ||
+		    cfgs[i].uV > regulators[regid].max_uV) {
 			dbg_very_loud("regulator (%d) set voltage failed\n",
-					cfgs[i].regulator);
-			return ret;
+				      regid);
+			return -1;
 		}
 
-		ret = mcp16502_regulator_set_enable(cfgs[i].regulator,
-						    cfgs[i].enable);
-		if (ret) {
-			dbg_very_loud("regulator (%d) enable failed\n",
-				      cfgs[i].regulator);
-			return ret;
-		}
+		selector[regid] = (MCP16502_LOW_SEL +
+				   div(cfgs[i].uV - regulators[regid].min_uV,
+				       regulators[regid].step_uV)) & MCP16502_VSEL;
+		enable[regid] = cfgs[i].enable ? MCP16502_EN : 0;
+		used |= 1 << regid;
+	}
+
+	/*
+	 * Setup regulators: read all of them in one queue, then write back
+	 * the ones that change in a second one.
+	 */
+	count = 0;
+	for (regid = MCP16502_MIN; regid <= MCP16502_MAX; regid++) {
+		if (!(used & (1 << regid)))
+			continue;
+
+		msgs[count].device_addr = addr;
+		msgs[count].iaddr_size = 1;
+		msgs[count].flags = TWI_MSG_READ;
+		msgs[count].internal_addr = MCP16502_BASE(regid);
+		msgs[count].data = &vals[regid];
+		msgs[count].bytes = 1;
+		count++;
+	}
+
+	if (!count)
+		return 0;
+
+	ret = twi_transfer(busid, msgs, count);
+	if (ret) {
+		dbg_very_loud("MCP16502: regulators read failed\n");
+		return ret;
 	}
 
-	return 0;
+	count = 0;
+	for (regid = MCP16502_MIN; regid <= MCP16502_MAX; regid++) {
+		unsigned char val;
+
+		if (!(used & (1 << regid)))
+			continue;
+
+		val = vals[regid] & ~(MCP16502_VSEL | MCP16502_EN);
+		val |= selector[regid] | enable[regid];
+		if (val == vals[regid])
+			continue;
+
+		vals[regid] = val;
+		msgs[count].device_addr = addr;
+		msgs[count].iaddr_size = 1;
+		msgs[count].flags = 0;
+		msgs[count].internal_addr = MCP16502_BASE(regid);
+		msgs[count].data = &vals[regid];
+		msgs[count].bytes = 1;
+		count++;
+	}
+
+	if (!count)
+		return 0;
+
+	ret = twi_transfer(busid, msgs, count);
+	if (ret)
+		dbg_very_loud("MCP16502: regulators setup failed\n");
+
+	return ret;
 }
 #if defined(CONFIG_MCP16502_SET_VOLTAGE)
 void mcp16502_voltage_select(void)
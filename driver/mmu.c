@@ -10,6 +10,7 @@
 #include "cp15.h"
 #include "l1cache.h"
 #include "mmu_cp15.h"
+#include "mmu.h"
 
 /*------------------------------------------------------------------------------ */
 /*         Exported functions                                                    */
@@ -49,3 +50,34 @@ void mmu_disable(void)
 	if (control & CP15_SCTLR_M)
 		cp15_write_sctlr(control & (~CP15_SCTLR_M));
 }
+
+/*
+ * The MMU and caches stay on from the end of hw_init() until the jump
+ * to the next stage, so that loading, authenticating, decrypting and
+ * relocating the image all run cached. Both calls may be repeated.
+ */
+void mmu_caches_enable(void)
+{
+	unsigned int *tlb = (unsigned int *)MMU_TABLE_BASE_ADDR;
+
+	if ((cp15_read_sctlr() & CP15_SCTLR_M) == 0) {
+		mmu_tlb_init(tlb);
+		mmu_configure(tlb);
+		mmu_enable();
+	}
+#ifdef CONFIG_CACHES
+	icache_enable();
+	dcache_enable();
+#endif
+}
+
+void mmu_caches_disable(void)
+{
+#ifdef CONFIG_CACHES
+	/* the next stage must find the image in memory, not in the cache */
+	dcache_disable();
+	icache_disable();
+#endif
+	mmu_disable();
+	isb();
+}
@@ -22,11 +22,22 @@
 #include "pmecc.h"
 #include "hamming.h"
 #include "timer.h"
+#include "bootstage.h"
 #include "fdt.h"
 #include "div.h"
+#include "string.h"
+#include "secure.h"
 #ifdef CONFIG_NAND_DMA_SUPPORT
 #include "xdmac.h"
+#ifdef CONFIG_CACHES
+#include "l1cache.h"
 #endif
+#endif
+
+/* Worst case busy times: reset, page read and block erase */
+#define NAND_RESET_TIMEOUT_US	5000
+#define NAND_READ_TIMEOUT_US	1000
+#define NAND_ERASE_TIMEOUT_US	10000
 
 #ifdef CONFIG_NANDFLASH_SMALL_BLOCKS
 static struct nand_chip nand_ids[] = {
@@ -330,11 +341,11 @@ static unsigned short read_word(void)
 
 static void nand_wait_ready(void)
 {
-	unsigned int timeout = 10000;
+	unsigned long long deadline = deadline_from_us(NAND_RESET_TIMEOUT_US);
 
 	nand_command(CMD_STATUS);
 	read_byte(); /* Dummy read, used as delay for tWHR */
-	while ((!(read_byte() & STATUS_READY)) && timeout--)
+	while ((!(read_byte() & STATUS_READY)) && !deadline_expired(deadline))
 		;
 }
 
@@ -540,6 +551,7 @@ static unsigned short onfi_crc16(unsigned short crc,
 #define		PARAMS_FEATURE_EXTENDED_PARAM	(0x1 << 7)
 
 #define PARAMS_OFFSET_OPT_CMD		8
+#define		PARAMS_OPT_CMD_READ_CACHE	(0x1 << 1)
 #define		PARAMS_OPT_CMD_SET_GET_FEATURES	(0x1 << 2)
 
 #define PARAMS_OFFSET_EXT_PARAM_PAGE_LEN	12
@@ -845,6 +857,10 @@ static int nand_info_init(struct nand_info *nand, struct nand_chip *chip)
 	nand->ecclayout = &nand_oob_layout;
 	/* data bus width (8/16 bits) */
 	nand->buswidth = chip->buswidth;
+#ifdef CONFIG_NAND_CACHE_READ
+	/* READ CACHE SEQUENTIAL / READ CACHE END */
+	nand->cache_read = !!(chip->opt_cmd & PARAMS_OPT_CMD_READ_CACHE);
+#endif
 	if (nand->buswidth) {
 		nand->ecclayout->badblockpos *= 2;
 		nand->command = nand_command16;
@@ -938,19 +954,15 @@ static void write_row_address(struct nand_info *nand,
 
 static int nand_read_status(void)
 {
-	unsigned int timeout = 1000;
+	unsigned long long deadline = deadline_from_us(NAND_READ_TIMEOUT_US);
 	unsigned char status;
 
 	nand_command(CMD_STATUS);
 	read_byte(); /* Dummy read, used as delay for tWHR */
-	do {
-		status = read_byte();
-		if (status & STATUS_READY)
-			break;
-	} while (--timeout);
-
-	if (!timeout)
-		return -1;
+	while (!((status = read_byte()) & STATUS_READY)) {
+		if (deadline_expired(deadline))
+			return -1;
+	}
 
 #ifdef CONFIG_ON_DIE_ECC
 	if (status & STATUS_ERROR) {
@@ -963,37 +975,124 @@ static int nand_read_status(void)
 }
 
 #ifdef CONFIG_NAND_DMA_SUPPORT
-static int nand_read_with_dma(unsigned char *buffer,
-			unsigned int len)
+static struct xdmac_hwcfg nand_dma_hwcfg = {
+	.pid = 0xFF,
+	.src_is_periph = 0,
+	.dst_is_periph = 0,
+};
+
+/* set when the channel stays configured from one page to the next */
+static unsigned int nand_dma_held;
+/* data width the channel is configured for */
+static unsigned int nand_dma_width;
+
+static int nand_dma_configure(unsigned int data_width)
 {
-	struct xdmac_hwcfg hwcfg;
 	struct xdmac_cfg cfg;
-	struct xdmac_transfer_cfg transfer_cfg;
 	int ret;
 
-	hwcfg.pid = 0xFF;
-	hwcfg.cid = 0;
-	hwcfg.src_is_periph = 0;
-	hwcfg.dst_is_periph = 0;
-	cfg.data_width = DMA_DATA_WIDTH_BYTE;
+	cfg.data_width = data_width;
 	cfg.chunk_size = DMA_CHUNK_SIZE_1;
 	cfg.burst_size = DMA_MEM_BURST_16;
 	cfg.incr_saddr = 1;
 	cfg.incr_daddr = 1;
-	ret = xdmac_configure_transfer(&hwcfg, &cfg);
-	if (ret)
-		goto dma_stop;
+
+	ret = xdmac_configure_transfer(&nand_dma_hwcfg, &cfg);
+	if (!ret)
+		nand_dma_width = data_width;
+
+	return ret;
+}
+
+static void nand_dma_hold(void)
+{
+	if (nand_dma_held || xdmac_request_channel(&nand_dma_hwcfg))
+		return;
+
+	/* the page buffers are normally double word aligned */
+	if (nand_dma_configure(DMA_DATA_WIDTH_DWORD)) {
+		xdmac_transfer_stop(&nand_dma_hwcfg);
+		return;
+	}
+
+	nand_dma_held = 1;
+}
+
+static void nand_dma_release(void)
+{
+	if (nand_dma_held) {
+		xdmac_transfer_stop(&nand_dma_hwcfg);
+		nand_dma_held = 0;
+	}
+}
+
+static int nand_read_with_dma(unsigned char *buffer,
+			unsigned int len)
+{
+	struct xdmac_transfer_cfg transfer_cfg;
+	struct xdmac_plan plan;
+	struct xdmac_cfg cfg;
+	unsigned int i;
+	int ret = 0;
+
+	/*
+	 * The data port reads the same at any address of the NAND window,
+	 * so the source can always be aligned like the buffer is.
+	 */
+	xdmac_plan_mem_transfer(&plan, &cfg,
+				(void *)((unsigned int)buffer & 0x7), buffer, len);
+
+	for (i = 0; i < plan.head; i++)
+		*buffer++ = read_byte();
+
+	if (!plan.len)
+		goto read_tail;
+
+	/* no channel left, the CPU moves the data */
+	if (!nand_dma_held && xdmac_request_channel(&nand_dma_hwcfg)) {
+		plan.tail += plan.len;
+		goto read_tail;
+	}
+
+	if (!nand_dma_held || nand_dma_width != cfg.data_width) {
+		ret = nand_dma_configure(cfg.data_width);
+		if (ret)
+			goto dma_stop;
+	}
+
+#ifdef CONFIG_CACHES
+	/* no dirty line may be written back over the DMA data */
+	dcache_clean_region((unsigned int)buffer,
+			    (unsigned int)buffer + plan.len);
+#endif
 	transfer_cfg.saddr = (void *)CONFIG_SYS_NAND_BASE;
 	transfer_cfg.daddr = (void *)buffer;
-	transfer_cfg.len = len;
-	ret = xdmac_transfer_start(&hwcfg, &transfer_cfg);
+	transfer_cfg.len = plan.len >> cfg.data_width;
+	ret = xdmac_transfer_start(&nand_dma_hwcfg, &transfer_cfg);
 	if (ret)
 		goto dma_stop;
-	ret = xdmac_transfer_wait_for_completion(&hwcfg);
+	ret = xdmac_transfer_wait_for_completion(&nand_dma_hwcfg);
+#ifdef CONFIG_CACHES
+	dcache_invalidate_region((unsigned int)buffer,
+				 (unsigned int)buffer + plan.len);
+#endif
+	buffer += plan.len;
 dma_stop:
-	xdmac_transfer_stop(&hwcfg);
-	return ret;
+	if (ret || !nand_dma_held) {
+		xdmac_transfer_stop(&nand_dma_hwcfg);
+		nand_dma_held = 0;
+	}
+	if (ret)
+		return ret;
+read_tail:
+	for (i = 0; i < plan.tail; i++)
+		*buffer++ = read_byte();
+
+	return 0;
 }
+#else
+static inline void nand_dma_hold(void) { }
+static inline void nand_dma_release(void) { }
 #endif
 
 #ifdef CONFIG_NANDFLASH_SMALL_BLOCKS
@@ -1061,13 +1160,15 @@ static int nand_read_sector(struct nand_info *nand,
 	return 0;
 }
 #else /* large blocks */
-static int nand_read_sector(struct nand_info *nand,
-				unsigned int row_address,
-				unsigned char *buffer, 
+/*
+ * Move the page out of the data register, once the device is ready and
+ * back in read mode, and correct it with the PMECC when reading data.
+ */
+static int nand_data_out(struct nand_info *nand,
+				unsigned char *buffer,
 				unsigned int zone_flag)
 {
 	unsigned int readbytes, i;
-	unsigned int column_address;
 	int ret = 0;
 	unsigned char *pbuf = buffer;
 
@@ -1085,36 +1186,21 @@ static int nand_read_sector(struct nand_info *nand,
 	switch (zone_flag) {
 	case ZONE_DATA:
 		readbytes = nand->pagesize;
-		column_address = 0x00;
 		break;
 
 	case ZONE_INFO:
 		readbytes = nand->oobsize;
 		pbuf += nand->pagesize;
-		column_address = nand->pagesize;
 		break;
 
 	case ZONE_DATA | ZONE_INFO:
 		readbytes = nand->sectorsize;
-		column_address = 0x00;
 		break;
 
 	default:
 		return -1;
 	}
 
-	nand_cs_enable();
-
-	nand->command(CMD_READ_1);
-
-	write_column_address(nand, column_address);
-	write_row_address(nand, row_address);
-
-	nand->command(CMD_READ_2);
-
-	if (nand_read_status())
-		return -1;
-
 	nand->command(CMD_READ_1);
 
 #ifdef CONFIG_USE_PMECC
@@ -1140,13 +1226,52 @@ static int nand_read_sector(struct nand_info *nand,
 #endif
 	}
 
+	return ret;
+}
+
+static int nand_read_sector(struct nand_info *nand,
+				unsigned int row_address,
+				unsigned char *buffer, 
+				unsigned int zone_flag)
+{
+	unsigned int column_address;
+	int ret;
+
+	switch (zone_flag) {
+	case ZONE_DATA:
+	case ZONE_DATA | ZONE_INFO:
+		column_address = 0x00;
+		break;
+
+	case ZONE_INFO:
+		column_address = nand->pagesize;
+		break;
+
+	default:
+		return -1;
+	}
+
+	nand_cs_enable();
+
+	nand->command(CMD_READ_1);
+
+	write_column_address(nand, column_address);
+	write_row_address(nand, row_address);
+
+	nand->command(CMD_READ_2);
+
+	if (nand_read_status())
+		return -1;
+
+	ret = nand_data_out(nand, buffer, zone_flag);
+
 	nand_cs_disable();
 
 	return ret;
 }
 #endif /* #ifdef CONFIG_NANDFLASH_SMALL_BLOCKS */
 
-static int nand_check_badblock(struct nand_info *nand,
+static int nand_scan_badblock(struct nand_info *nand,
 				unsigned int block,
 				unsigned char *buffer)
 {
@@ -1177,6 +1302,22 @@ static void nand_read_ecc(struct nand_ooblayout *ooblayout,
 	for (i = 0; i < ooblayout->eccbytes; i++)
 		ecc[i] = buffer[ooblayout->eccpos[i]];
 }
+
+static int nand_verify_sw_ecc(struct nand_info *nand,
+				unsigned char *buffer)
+{
+	unsigned char hamming[48], error;
+
+	nand_read_ecc(nand->ecclayout, buffer + nand->pagesize, hamming);
+
+	error = Hamming_Verify256x(buffer, nand->pagesize, hamming);
+	if (error && (error != Hamming_ERROR_SINGLEBIT)) {
+		dbg_info("NAND: Hamming ECC error!\n");
+		return -1;
+	}
+
+	return 0;
+}
 #endif
 
 static int nand_read_page(struct nand_info *nand,
@@ -1190,33 +1331,125 @@ static int nand_read_page(struct nand_info *nand,
 #ifndef CONFIG_ENABLE_SW_ECC
 	return nand_read_sector(nand, row_address, buffer, ZONE_DATA);
 #else
+	if (nand_read_sector(nand, row_address, buffer,
+				ZONE_DATA | ZONE_INFO))
+		return -1;
 
-	int retval;
-	unsigned char hamming[48], error;
+	return nand_verify_sw_ecc(nand, buffer);
+#endif /* #ifndef CONFIG_ENABLE_SW_ECC */
+}
 
-	retval = nand_read_sector(nand, row_address, buffer,
-				ZONE_DATA | ZONE_INFO);
-	if (retval)
-		return -1;
+#ifdef CONFIG_NAND_CACHE_READ
+/*
+ * Once the first page is in the data register, each READ CACHE command
+ * moves it to the cache register and starts loading the next one, so
+ * the array read of page N+1 runs while page N is moved out and corrected.
+ */
+static int nand_read_pages_cached(struct nand_info *nand,
+				unsigned int block,
+				unsigned int start_page,
+				unsigned int numpages,
+				unsigned char *buffer)
+{
+	unsigned int row_address = block * nand->pages_block + start_page;
+#ifdef CONFIG_ENABLE_SW_ECC
+	unsigned int zone_flag = ZONE_DATA | ZONE_INFO;
+#else
+	unsigned int zone_flag = ZONE_DATA;
+#endif
+	unsigned int page;
+	int ret = 0;
 
-	nand_read_ecc(nand->ecclayout, buffer + nand->pagesize, hamming);
+	nand_cs_enable();
 
-	error = Hamming_Verify256x(buffer, nand->pagesize, hamming);
-	if (error && (error != Hamming_ERROR_SINGLEBIT)) {
-		dbg_info("NAND: Hamming ECC error!\n");
-		return -1;
+	nand->command(CMD_READ_1);
+
+	write_column_address(nand, 0);
+	write_row_address(nand, row_address);
+
+	nand->command(CMD_READ_2);
+
+	if (nand_read_status()) {
+		ret = -1;
+		goto exit;
 	}
 
-	return 0;
-#endif /* #ifndef CONFIG_ENABLE_SW_ECC */
+	for (page = 0; page < numpages; page++) {
+		if (page == numpages - 1)
+			nand->command(CMD_READ_CACHE_END);
+		else
+			nand->command(CMD_READ_CACHE_SEQ);
+
+		if (nand_read_status()) {
+			ret = -1;
+			break;
+		}
+
+		ret = nand_data_out(nand, buffer, zone_flag);
+#ifdef CONFIG_ENABLE_SW_ECC
+		if (!ret)
+			ret = nand_verify_sw_ecc(nand, buffer);
+#endif
+		if (ret)
+			break;
+
+		buffer += nand->pagesize;
+	}
+
+	/* leave the cache read mode if it was cut short */
+	if (page < numpages - 1)
+		nand->command(CMD_RESET);
+
+exit:
+	nand_cs_disable();
+
+	return ret;
+}
+#endif
+
+/* Read whole pages of a block, the DMA channel is set up once for all */
+static int nand_read_pages(struct nand_info *nand,
+				unsigned int block,
+				unsigned int start_page,
+				unsigned int numpages,
+				unsigned char *buffer)
+{
+	unsigned int page;
+	int ret = 0;
+
+	nand_dma_hold();
+
+#ifdef CONFIG_NAND_CACHE_READ
+	if (nand->cache_read && numpages > 1) {
+		ret = nand_read_pages_cached(nand, block, start_page,
+					     numpages, buffer);
+		goto exit;
+	}
+#endif
+
+	for (page = start_page; page < start_page + numpages; page++) {
+		ret = nand_read_page(nand, block, page, ZONE_DATA, buffer);
+		if (ret)
+			break;
+
+		buffer += nand->pagesize;
+	}
+
+#ifdef CONFIG_NAND_CACHE_READ
+exit:
+#endif
+	nand_dma_release();
+
+	return ret;
 }
 
 #ifdef CONFIG_NANDFLASH_RECOVERY
 static int nand_erase_block0(struct nand_info *nand)
 {
 	unsigned int row_address = 0;
-	unsigned int timeout = 10000;
+	unsigned long long deadline;
 	unsigned int status;
+	int timeout = 0;
 
 	nand_cs_enable();
 
@@ -1224,19 +1457,23 @@ static int nand_erase_block0(struct nand_info *nand)
 	write_row_address(nand, row_address);
 	nand_command(CMD_ERASE_2);
 
-	udelay(2000);
+	deadline = deadline_from_us(NAND_ERASE_TIMEOUT_US);
 
 	nand_command(CMD_STATUS);
 	read_byte(); /* Dummy read, used as delay for tWHR */
-	while ((!((status = read_byte()) & STATUS_READY)) && --timeout)
-		;
+	while (!((status = read_byte()) & STATUS_READY)) {
+		if (deadline_expired(deadline)) {
+			timeout = 1;
+			break;
+		}
+	}
 
 	nand_cs_disable();
 
 	if (status & STATUS_ERROR)
 		return -1;
 
-	if (timeout == 0)
+	if (timeout)
 		return -2;
 
 	return 0;
@@ -1269,6 +1506,139 @@ static int nandflash_recovery(struct nand_info *nand)
 }
 #endif /* #ifdef CONFIG_NANDFLASH_RECOVERY */
 
+#ifdef CONFIG_NAND_BBT
+/*
+ * Bad block state of the first NAND_BBT_MAX_BLOCKS blocks, filled in as
+ * the blocks are scanned or all at once from the on-flash table, so that
+ * every load path pays for the OOB reads of a block once per boot.
+ */
+#define NAND_BBT_MAX_BLOCKS	4096
+
+static unsigned char nand_bbt_known[NAND_BBT_MAX_BLOCKS / 8];
+static unsigned char nand_bbt_bad[NAND_BBT_MAX_BLOCKS / 8];
+
+#ifdef CONFIG_NAND_BBT_ON_FLASH
+/*
+ * Linux MTD on-flash table: the main ("Bbt0") or mirror ("1tbB") pattern
+ * and a version byte in the OOB of the first page of one of the last
+ * four blocks, then 2 bits per block in the page data, 0b11 for good.
+ */
+#define NAND_BBT_SCAN_BLOCKS	4
+#define NAND_BBT_PATTERN_OFFS	8
+#define NAND_BBT_VERSION_OFFS	12
+
+static const unsigned char bbt_main_pattern[] = {'B', 'b', 't', '0'};
+static const unsigned char bbt_mirror_pattern[] = {'1', 't', 'b', 'B'};
+
+static int nand_bbt_find(struct nand_info *nand,
+			 const unsigned char *pattern,
+			 unsigned char *buffer,
+			 unsigned int *version)
+{
+	unsigned char *oob = buffer + nand->pagesize;
+	unsigned int block;
+	unsigned int i;
+
+	for (i = 0; i < NAND_BBT_SCAN_BLOCKS; i++) {
+		block = nand->numblocks - 1 - i;
+		if (nand_read_sector(nand, block * nand->pages_block,
+				     buffer, ZONE_INFO))
+			continue;
+
+		if (!memcmp(oob + NAND_BBT_PATTERN_OFFS, pattern, 4)) {
+			*version = oob[NAND_BBT_VERSION_OFFS];
+			return block;
+		}
+	}
+
+	return -1;
+}
+
+static int nand_bbt_read(struct nand_info *nand,
+			 unsigned int bbt_block,
+			 unsigned char *buffer)
+{
+	unsigned int length = (nand->numblocks + 3) >> 2;
+	unsigned int numpages = div(length + nand->pagesize - 1,
+				    nand->pagesize);
+	unsigned int block, code;
+
+	if (nand_read_pages(nand, bbt_block, 0, numpages, buffer))
+		return -1;
+
+	for (block = 0; block < nand->numblocks; block++) {
+		code = (buffer[block >> 2] >> ((block & 3) << 1)) & 0x3;
+		if (code != 0x3)
+			nand_bbt_bad[block >> 3] |= 1 << (block & 7);
+		else
+			nand_bbt_bad[block >> 3] &= ~(1 << (block & 7));
+
+		nand_bbt_known[block >> 3] |= 1 << (block & 7);
+	}
+
+	return 0;
+}
+
+/* Load the newest readable copy of the on-flash table, if there is one */
+static void nand_bbt_init(struct nand_info *nand, unsigned char *buffer)
+{
+	unsigned int main_version = 0, mirror_version = 0;
+	int main_block, mirror_block;
+	int first, second;
+
+	if (nand->numblocks > NAND_BBT_MAX_BLOCKS)
+		return;
+
+	main_block = nand_bbt_find(nand, bbt_main_pattern,
+				   buffer, &main_version);
+	mirror_block = nand_bbt_find(nand, bbt_mirror_pattern,
+				     buffer, &mirror_version);
+
+	if (mirror_block >= 0 &&
+	    (main_block < 0 || mirror_version > main_version)) {
+		first = mirror_block;
+		second = main_block;
+	} else {
+		first = main_block;
+		second = mirror_block;
+	}
+
+	if (first >= 0 && !nand_bbt_read(nand, first, buffer)) {
+		dbg_info("NAND: Bad block table at block %d\n", first);
+		return;
+	}
+
+	if (second >= 0 && !nand_bbt_read(nand, second, buffer)) {
+		dbg_info("NAND: Bad block table at block %d\n", second);
+		return;
+	}
+
+	dbg_loud("NAND: No bad block table found\n");
+}
+#endif /* #ifdef CONFIG_NAND_BBT_ON_FLASH */
+#endif /* #ifdef CONFIG_NAND_BBT */
+
+static int nand_check_badblock(struct nand_info *nand,
+				unsigned int block,
+				unsigned char *buffer)
+{
+#ifdef CONFIG_NAND_BBT
+	unsigned char mask = 1 << (block & 7);
+	unsigned int index = block >> 3;
+
+	if (block < NAND_BBT_MAX_BLOCKS) {
+		if (!(nand_bbt_known[index] & mask)) {
+			if (nand_scan_badblock(nand, block, buffer))
+				nand_bbt_bad[index] |= mask;
+			nand_bbt_known[index] |= mask;
+		}
+
+		return (nand_bbt_bad[index] & mask) ? -1 : 0;
+	}
+#endif
+	return nand_scan_badblock(nand, block, buffer);
+}
+
 static int nand_loadimage(struct nand_info *nand,
 				unsigned int offset,
 				unsigned int length,
@@ -1277,9 +1647,7 @@ static int nand_loadimage(struct nand_info *nand,
 	unsigned char *buffer = dest;
 	unsigned int readsize;
 	unsigned int block = 0;
-	unsigned int page;
 	unsigned int start_page = 0;
-	unsigned int end_page;
 	unsigned int numpages = 0;
 	unsigned int offsetpage = 0;
 	unsigned int block_remaining = nand->blocksize
@@ -1289,6 +1657,7 @@ static int nand_loadimage(struct nand_info *nand,
 	division(offset, nand->blocksize, &block, &start_page);
 	start_page = div(start_page, nand->pagesize);
 
+	secure_stream_update(dest, 0);
 	while (length > 0) {
 		/* read a buffer corresponding to a block */
 		if (length < block_remaining)
@@ -1301,8 +1670,6 @@ static int nand_loadimage(struct nand_info *nand,
 		if (offsetpage)
 			numpages++;
 
-		end_page = start_page + numpages;
-
 		/* check the bad block */
 		while (1) {
 			if (nand_check_badblock(nand,
@@ -1315,16 +1682,14 @@ static int nand_loadimage(struct nand_info *nand,
 		}
 
 		/* read pages of a block */
-		for (page = start_page; page < end_page; page++) {
-
-			ret = nand_read_page(nand, block, page,
-						ZONE_DATA, buffer);
-			if (ret)
-				return -1;
-			else
-				buffer += nand->pagesize;
-		}
+		ret = nand_read_pages(nand, block, start_page,
+				      numpages, buffer);
+		if (ret)
+			return -1;
+
+		buffer += numpages * nand->pagesize;
 		length -= readsize;
+		secure_stream_update(dest, buffer - dest);
 
 		block++;
 		start_page = 0;
@@ -1384,6 +1749,11 @@ int load_nandflash(struct image_info *image)
 	dbg_info("NAND: Using Software ECC\n");
 #endif
 
+#ifdef CONFIG_NAND_BBT_ON_FLASH
+	nand_bbt_init(&nand, image->dest);
+#endif
+	bootstage_mark(BOOTSTAGE_MEDIA_INIT);
+
 #if defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
 	int length = update_image_length(&nand,
 				image->offset, image->dest, KERNEL_IMAGE);
@@ -1391,6 +1761,7 @@ int load_nandflash(struct image_info *image)
 		return -1;
 
 	image->length = length;
+	kernel_placement(image);
 #endif
 
 	dbg_info("NAND: Image: Copy %x bytes from %x to %x\n",
@@ -7,6 +7,7 @@
 #include "optee.h"
 #include "types.h"
 #include "string.h"
+#include "usart.h"
 
 #define OPTEE_MAGIC             0x4554504f
 #define OPTEE_VERSION           1
@@ -104,12 +105,15 @@ static void optee_load_image(void **page_store)
 	ret = load_func(&image);
 	if (ret) {
 		dbg_loud("Failed to load OP-TEE\n");
+		usart_flush();
 		while(1);
 	}
 
 	ret = optee_image_check(&image, page_store, &optee_size);
-	if (ret < 0)
+	if (ret < 0) {
+		usart_flush();
 		while(1);
+	}
 
 	/*
 	 * Since OP-TEE is loaded by default at 0x20000000 which is the DDR
@@ -141,6 +145,7 @@ void optee_load(void)
 
 	dbg_info("Starting OP-TEE, Run at %x, Non-secure entry at %x\n",
 		 CONFIG_OPTEE_JUMP_ADDR, nw_params.nw_addr);
+	usart_flush();
 
 	optee_start(page_store, nw_params.r1, nw_params.r2, nw_params.nw_addr);
 }
@@ -6,6 +6,7 @@
 #include "board.h"
 #include "debug.h"
 #include "div.h"
+#include "idle.h"
 #include "pmc.h"
 #include "types.h"
 
@@ -24,6 +25,12 @@
 #define MAX_PIT64B	(~0UL)
 
 static u32 clk_rate = 0;
+/* microseconds per tick in 0.64 fixed point, see ticks_to_us() */
+static u32 us_mult_high;
+static u32 us_mult_low;
+/* ticks per microsecond in 32.32 fixed point, see us_to_ticks() */
+static u32 ticks_per_us;
+static u32 ticks_per_us_frac;
 
 static inline unsigned int pit64b_readl(unsigned int reg)
 {
@@ -35,6 +42,28 @@ static inline void pit64b_writel(unsigned int value, unsigned reg)
 	writel(value, (AT91C_BASE_PIT64BC + reg));
 }
 
+/*
+ * (num << bits) / den for num < den, one quotient bit at a time: there
+ * is no 64-bit division, and this only runs once at init.
+ */
+static u64 pit64b_frac(u32 num, u32 den, int bits)
+{
+	u64 rem = num;
+	u64 quot = 0;
+	int i;
+
+	for (i = 0; i < bits; i++) {
+		rem <<= 1;
+		quot <<= 1;
+		if (rem >= den) {
+			rem -= den;
+			quot |= 1;
+		}
+	}
+
+	return quot;
+}
+
 /**
  * timer_init() - initialize timer to be used for {u, m}delay() operations
  *
@@ -43,8 +72,24 @@ static inline void pit64b_writel(unsigned int value, unsigned reg)
  */
 int timer_init(void)
 {
+	unsigned int quot, rem;
+	u64 mult;
+
 	pmc_enable_periph_clock(AT91C_ID_PIT64B, PMC_PERIPH_CLK_DIVIDER_NA);
 	clk_rate = pmc_periph_clock_get_rate(AT91C_ID_PIT64B);
+
+	/*
+	 * The clock need not be a whole number of MHz: keep the fractions,
+	 * so that both conversions stay within two ticks or microseconds
+	 * however long the timer has run.
+	 */
+	mult = pit64b_frac(1000000, clk_rate, 64);
+	us_mult_high = mult >> 32;
+	us_mult_low = mult;
+	division(clk_rate, 1000000, &quot, &rem);
+	ticks_per_us = quot;
+	ticks_per_us_frac = pit64b_frac(rem, 1000000, 32);
+
 	/*
 	 * Set it at maximum value. It is enough even for a peripheral
 	 * clock running at 1GHz.
@@ -68,26 +113,57 @@ static u64 pit64b_read_value(void)
 	return (((u64)high << 32) | low);
 }
 
+unsigned long long get_ticks(void)
+{
+	return pit64b_read_value();
+}
+
+static unsigned long long pit64b_ticks_to_us(unsigned long long ticks)
+{
+	u32 high = ticks >> 32;
+	u32 low = ticks;
+
+	/* (ticks * us_mult) >> 64, the terms dropped are worth under 2 us */
+	return (u64)high * us_mult_high
+		+ (((u64)high * us_mult_low) >> 32)
+		+ (((u64)low * us_mult_high) >> 32);
+}
+
+unsigned int ticks_to_us(unsigned long long ticks)
+{
+	return (unsigned int)pit64b_ticks_to_us(ticks);
+}
+
+unsigned long long get_time_us(void)
+{
+	return pit64b_ticks_to_us(pit64b_read_value());
+}
+
+unsigned long long us_to_ticks(unsigned long long usec)
+{
+	u32 high = usec >> 32;
+	u32 low = usec;
+
+	/* usec * ticks per microsecond, the fraction without a 96-bit product */
+	return usec * ticks_per_us + (u64)high * ticks_per_us_frac
+		+ (((u64)low * ticks_per_us_frac) >> 32);
+}
+
 void udelay(unsigned int usec)
 {
-	u64 base = pit64b_read_value();
-	u64 end = base + (clk_rate / 1000000) * usec;
-	u64 current;
+	u64 end = pit64b_read_value() + us_to_ticks(usec);
 
-	do {
-		current = pit64b_read_value();
-	} while (current < end);
+	/* no background work here, callers may be timing bus slots */
+	while (pit64b_read_value() < end)
+		;
 }
 
 void mdelay(unsigned int msec)
 {
-	u64 base = pit64b_read_value();
-	u64 end = base + (clk_rate / 1000) * msec;
-	u64 current;
+	u64 end = pit64b_read_value() + us_to_ticks((u64)msec * 1000);
 
-	do {
-		current = pit64b_read_value();
-	} while (current < end);
+	while (pit64b_read_value() < end)
+		idle_poll();
 }
 
 /* Init a special timer for slow clock switch function */
@@ -102,12 +178,10 @@ int start_interval_timer(void)
 
 int wait_interval_timer(unsigned int msec)
 {
-	u64 end = timer1_base + (clk_rate / 1000) * msec;
-	u64 current;
+	u64 end = timer1_base + us_to_ticks((u64)msec * 1000);
 
-	do {
-		current = pit64b_read_value();
-	} while (current < end);
+	while (pit64b_read_value() < end)
+		;
 
 	return 0;
 }
@@ -136,97 +136,55 @@ static short *pmecc_gf;
 #define PMECC_INDEX_TABLE_SIZE_1024	0x4000
 /* work for sama5d3, at91sam9x5, at91sam9n12 */
 #define PMECC_GF_TABLE_ADDR_IN_DDR	0x21000000
+/*
+ * Primitive polynomials of GF(2^mm), without the x^mm term: bit i is
+ * the coefficient of x^i.
+ */
+static const unsigned short gf_poly[16] = {
+	[3]  = 0x0003,	/* 1 + x */
+	[4]  = 0x0003,	/* 1 + x */
+	[5]  = 0x0005,	/* 1 + x^2 */
+	[6]  = 0x0003,	/* 1 + x */
+	[7]  = 0x0009,	/* 1 + x^3 */
+	[8]  = 0x001d,	/* 1 + x^2 + x^3 + x^4 */
+	[9]  = 0x0011,	/* 1 + x^4 */
+	[10] = 0x0009,	/* 1 + x^3 */
+	[11] = 0x0005,	/* 1 + x^2 */
+	[12] = 0x0053,	/* 1 + x + x^4 + x^6 */
+	[13] = 0x001b,	/* 1 + x + x^3 + x^4 */
+	[14] = 0x0443,	/* 1 + x + x^6 + x^10 */
+	[15] = 0x0003,	/* 1 + x */
+};
+
 /*
  * \brief This fuction is able to build Galois Field.
  * \param mm degree of the remainders.
  * \param index_of Pointer to a buffer for index_of table.
  * \param alpha_to Pointer to a buffer for alpha_to table.
+ *
+ * The powers of alpha are the successive states of an LFSR: each step
+ * multiplies by alpha, feeding the polynomial back when x^mm appears.
  */
 static void build_gf(unsigned int mm, short *index_of, short *alpha_to)
 {
+	unsigned int nn = (1 << mm) - 1;
+	unsigned int msb = 1 << (mm - 1);
+	unsigned int value = 1;
 	unsigned int i;
-	unsigned int mask;
-	unsigned int nn;
-	unsigned int p[15];
-
-	nn = (1 << mm) - 1;
-	/* set default value */
-	for (i = 1; i < mm; i++)
-		p[i] = 0;
-
-	/* 1 + X^mm */
-	p[0]  = 1;
-	p[mm] = 1;
-
-	/*  others  */
-	if (mm == 3)
-		p[1] = 1;
-	else if (mm == 4)
-		p[1] = 1;
-	else if (mm == 5)
-		p[2] = 1;
-	else if (mm == 6)
-		p[1] = 1;
-	else if (mm == 7)
-		p[3] = 1;
-	else if (mm == 8)
-		p[2] = p[3] = p[4] = 1;
-	else if (mm == 9)
-		p[4] = 1;
-	else if (mm == 10)
-		p[3] = 1;
-	else if (mm == 11)
-		p[2] = 1;
-	else if (mm == 12)
-		p[1] = p[4] = p[6] = 1;
-	else if (mm == 13)
-		p[1] = p[3] = p[4] = 1;
-	else if (mm == 14)
-		p[1] = p[6] = p[10] = 1;
-	else if (mm == 15)
-		p[1] = 1;
-
-	/*-- First of All */
-	/*-- build alpha ^ mm it will help to generate the field (primitiv) */
-	alpha_to[mm] = 0;
-	for (i = 0; i < mm; i++) {
-		if (p[i])
-			alpha_to[mm] |= 1 << i;
-	}
 
-	/* Secondly */
-	/* Build elements from 0 to mm - 1 */
-	/* very easy because degree is less than mm so it is */
-	/* just a logical shift ! (only the remainder) */
-	mask = 1;
-	for (i = 0; i < mm; i++) {
-		alpha_to[i] = mask;
-		index_of[alpha_to[i]] = i;
-		mask <<= 1;
-	}
-
-	index_of[alpha_to[mm]] = mm ;
-
-	/* use a mask to select the MSB bit of the */
-	/* LFSR ! */
-	mask >>= 1; /* previous value moust be decremented */
+	for (i = 0; i < nn; i++) {
+		alpha_to[i] = value;
+		index_of[value] = i;
 
-	/* then finish the building */
-	for (i = mm + 1; i <= nn; i++) {
-		/* check if the msb bit of the lfsr is set */
-		if (alpha_to[i-1] & mask) {
-			/* feedback loop is set */
-			alpha_to[i] = alpha_to[mm]
-					^ ((alpha_to[i-1] ^ mask) << 1);
-		} else {
-			/*  only shift is enabled */
-			alpha_to[i] = alpha_to[i-1] << 1;
-		}
-		/*  lookup table */
-		/* index_of[alpha_to[i]] = i; */
-		index_of[alpha_to[i]] = mod(i, nn);
+		if (value & msb)
+			value = ((value ^ msb) << 1) ^ gf_poly[mm];
+		else
+			value <<= 1;
 	}
 
+	/* alpha ^ nn wraps around to 1 */
+	alpha_to[nn] = value;
+
 	/* of course index of 0 is undefined in a multiplicative field */
 	index_of[0] = -1;
 }
@@ -441,6 +399,19 @@ static void GenSyn(unsigned long pPMECC,
 						= pRemainer[index];
 }
 
+/*
+ * Reduce a sum of field element indexes modulo nn. The sums handled by
+ * the decoder are below 3 * nn, two subtractions at most replace a
+ * division on the hot path.
+ */
+static inline unsigned int gf_reduce(unsigned int index, unsigned int nn)
+{
+	while (index >= nn)
+		index -= nn;
+
+	return index;
+}
+
 /**
  * \brief The substitute function evaluates the polynomial remainder,
  * with different values of the field primitive elements.
@@ -478,7 +449,7 @@ static int substitute(struct _PMECC_paramDesc_struct *pPmeccDescriptor)
 		if (si[j] == 0)
 			si[i] = 0;
 		else
-			si[i] = alpha_to[mod((2 * index_of[si[j]]),
+			si[i] = alpha_to[gf_reduce((2 * index_of[si[j]]),
 				(unsigned int)pPmeccDescriptor->nn)];
 	}
 
@@ -626,7 +597,7 @@ static unsigned int get_sigma(struct _PMECC_paramDesc_struct *pPmeccDescriptor)
 			/* Compute smu[i+1] */
 			for (k = 0; k <= lmu[ro]>>1; k++)
 				if (pPmeccDescriptor->smu[ro][k] && dmu[i])
-					pPmeccDescriptor->smu[i + 1][k + diff] = pPmeccDescriptor->alpha_to[mod((pPmeccDescriptor->index_of[dmu[i]]
+					pPmeccDescriptor->smu[i + 1][k + diff] = pPmeccDescriptor->alpha_to[gf_reduce((pPmeccDescriptor->index_of[dmu[i]]
 						+ (pPmeccDescriptor->nn	- pPmeccDescriptor->index_of[dmu[ro]])
 						+ pPmeccDescriptor->index_of[pPmeccDescriptor->smu[ro][k]]), (unsigned int)pPmeccDescriptor->nn)];
 
@@ -652,7 +623,7 @@ static unsigned int get_sigma(struct _PMECC_paramDesc_struct *pPmeccDescriptor)
 				 * is null, its index is -1
 				 */
 				else if (pPmeccDescriptor->smu[i+1][k] && si[2 * (i - 1) + 3 - k])
-					dmu[i + 1] = pPmeccDescriptor->alpha_to[mod((pPmeccDescriptor->index_of[pPmeccDescriptor->smu[i + 1][k]]
+					dmu[i + 1] = pPmeccDescriptor->alpha_to[gf_reduce((pPmeccDescriptor->index_of[pPmeccDescriptor->smu[i + 1][k]]
 							+ pPmeccDescriptor->index_of[si[2 * (i - 1) + 3 - k]]), (unsigned int)pPmeccDescriptor->nn)] ^ dmu[i + 1];
 			}
 		}
@@ -691,8 +662,12 @@ static int ErrorLocation(unsigned long pPMERRLOC,
 		errorNumber++;
 	}
 
+	/*
+	 * Write the number of errors of this sector, not OR it into the
+	 * one of the previous sector corrected in the page.
+	 */
 	pmecclor_writel(((errorNumber - 1) << 16)
-			| pmecclor_readl(PMERRLOC_ELCFG), PMERRLOC_ELCFG);
+			| (pPmeccDescriptor->sectorSize >> 4), PMERRLOC_ELCFG);
 	/* Enable error location process */
 	pmecclor_writel(SectorSizeInBits, PMERRLOC_ELEN);
 
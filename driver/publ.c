@@ -8,6 +8,7 @@
 #include "debug.h"
 #include "hardware.h"
 #include "timer.h"
+#include "rstc.h"
 
 #include "publ_regs.h"
 #include "publ.h"
@@ -318,6 +319,110 @@ int publ_train()
 	return 0;
 }
 
+#ifdef CONFIG_PUBL_TRAINING_CACHE
+/*
+ * Results of the DQS gate and read valid training, kept in SECURAM so that
+ * a warm reset can skip the training. They are tied to the PHY setup they
+ * were measured with, and always measured again after a power-on reset.
+ * ZQ calibration is not cached: it follows the temperature and the supply,
+ * and it is short anyway.
+ */
+#define PUBL_TRAINING_MAGIC	0x7452414eUL	/* "tRAN" */
+#define PUBL_TRAINING_REJECTED	0x78524a43UL	/* "xRJC" */
+
+struct publ_training {
+	unsigned int magic;
+	unsigned int key;
+	unsigned int dqtr[PUBL_DX_LANES];
+	unsigned int dqstr[PUBL_DX_LANES];
+	unsigned int check;
+};
+
+#define PUBL_TRAINING \
+	((struct publ_training *)CONFIG_PUBL_TRAINING_CACHE_ADDR)
+
+static unsigned int publ_hash(unsigned int hash, unsigned int data)
+{
+	/* FNV-1a, one word at a time */
+	return (hash ^ data) * 16777619;
+}
+
+/* Digest of the PHY and DRAM setup done by publ_init() */
+static unsigned int publ_config_key(void)
+{
+	const volatile unsigned int *reg;
+	unsigned int key = 2166136261U;
+
+	for (reg = &PUBL->PUBL_PTR0; reg <= &PUBL->PUBL_ODTCR; reg++)
+		key = publ_hash(key, *reg);
+
+	key = publ_hash(key, PUBL->PUBL_PGCR);
+
+	return publ_hash(key, PUBL->PUBL_ZQ0CR1);
+}
+
+static unsigned int publ_training_check(const struct publ_training *cache)
+{
+	const unsigned int *word = (const unsigned int *)cache;
+	unsigned int check = 2166136261U;
+
+	while (word < &cache->check)
+		check = publ_hash(check, *word++);
+
+	return check;
+}
+
+int publ_restore_training(void)
+{
+	struct publ_training *cache = PUBL_TRAINING;
+	int i;
+
+	/* only reuse results measured with the board powered since */
+	if (!rstc_is_warm_reset()) {
+		cache->magic = 0;
+		return -1;
+	}
+
+	if (cache->magic != PUBL_TRAINING_MAGIC ||
+	    cache->key != publ_config_key() ||
+	    cache->check != publ_training_check(cache))
+		return -1;
+
+	for (i = 0; i < PUBL_DX_LANES; i++) {
+		PUBL->PUBL_DX[i].PUBL_DXDQTR = cache->dqtr[i];
+		PUBL->PUBL_DX[i].PUBL_DXDQSTR = cache->dqstr[i];
+	}
+
+	dbg_info("PUBL: Training restored.\n");
+
+	return 0;
+}
+
+void publ_save_training(void)
+{
+	struct publ_training *cache = PUBL_TRAINING;
+	unsigned int key = publ_config_key();
+	int i;
+
+	/* the saved results failed with this setup, until the next power-on */
+	if (cache->magic == PUBL_TRAINING_REJECTED && cache->key == key)
+		return;
+
+	cache->magic = PUBL_TRAINING_MAGIC;
+	cache->key = key;
+	for (i = 0; i < PUBL_DX_LANES; i++) {
+		cache->dqtr[i] = PUBL->PUBL_DX[i].PUBL_DXDQTR;
+		cache->dqstr[i] = PUBL->PUBL_DX[i].PUBL_DXDQSTR;
+	}
+	cache->check = publ_training_check(cache);
+}
+
+void publ_drop_training(void)
+{
+	PUBL_TRAINING->magic = PUBL_TRAINING_REJECTED;
+}
+#endif /* CONFIG_PUBL_TRAINING_CACHE */
+
 int publ_bypass_zq_calibration(void)
 {
 	if (!backup_resume())
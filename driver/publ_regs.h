@@ -21,6 +21,9 @@
  * Synopsys PUBL DDR PHY register map configuration.
  */
 
+/* Byte lanes of the 16-bit DDR interface */
+#define PUBL_DX_LANES	2
+
 struct publ_regs {
 	/* Revision Identification Register */
 	__I  unsigned int PUBL_RIDR;
@@ -85,6 +88,24 @@ struct publ_regs {
 	/* ZQ 0 Impedance Control Register 1 */
 	__IO unsigned int PUBL_ZQ0CR1;
 	__IO unsigned int PUBL_ZQ0SR0;
+	/* Unused */
+	__I unsigned int Reserved5[13];
+	/* DATX8 byte lane registers, 0x40 apart */
+	struct {
+		/* DATX8 General Configuration Register */
+		__IO unsigned int PUBL_DXGCR;
+		/* DATX8 General Status Registers 0 and 1 */
+		__I  unsigned int PUBL_DXGSR0;
+		__I  unsigned int PUBL_DXGSR1;
+		/* DATX8 DLL Control Register */
+		__IO unsigned int PUBL_DXDLLCR;
+		/* DATX8 DQ Timing Register */
+		__IO unsigned int PUBL_DXDQTR;
+		/* DATX8 DQS Timing Register */
+		__IO unsigned int PUBL_DXDQSTR;
+		/* Unused */
+		__I unsigned int Reserved[10];
+	} PUBL_DX[PUBL_DX_LANES];
 };
 
 /* PUBL register helpers
@@ -10,16 +10,14 @@
 #include "string.h"
 
 #include "ff.h"
+#include "secure.h"
 
 #include "debug.h"
 
-#define CHUNK_SIZE	0x40000
-
 static int sdcard_loadimage(char *filename, BYTE *dest)
 {
 	FIL 	file;
-	UINT	byte_to_read = CHUNK_SIZE;
-	UINT	byte_read;
+	DWORD	byte_read, chunk;
 	FRESULT	fret;
 	int	ret;
 
@@ -30,16 +28,20 @@ static int sdcard_loadimage(char *filename, BYTE *dest)
 		goto open_fail;
 	}
 
-	do {
-		byte_read = 0;
-		fret = f_read(&file, (void *)(dest), byte_to_read, &byte_read);
-		dest += byte_to_read;
-	} while (byte_read >= byte_to_read);
-
-	if (fret != FR_OK) {
-		dbg_info("*** FATFS: f_read: error\n");
-		 ret = -1;
-		goto read_fail;
+	secure_stream_update(dest, 0);
+	while (file.fptr < file.fsize) {
+		chunk = file.fsize - file.fptr;
+		if (chunk > SECURE_STREAM_CHUNK)
+			chunk = SECURE_STREAM_CHUNK;
+
+		fret = f_load_contiguous(&file, (void *)(dest + file.fptr),
+					 chunk, &byte_read);
+		if (fret != FR_OK || !byte_read) {
+			dbg_info("*** FATFS: f_read: error\n");
+			ret = -1;
+			goto read_fail;
+		}
+		secure_stream_update(dest, file.fptr);
 	}
 	ret = 0;
 
@@ -51,6 +53,27 @@ open_fail:
 
 }
 
+#if defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
+#define SDCARD_HEADER_SIZE	512
+
+/* Read the start of the kernel image, for kernel_placement() */
+static int sdcard_read_header(char *filename, BYTE *dest)
+{
+	FIL	file;
+	UINT	byte_read;
+	FRESULT	fret;
+
+	fret = f_open(&file, filename, FA_OPEN_EXISTING | FA_READ);
+	if (fret != FR_OK)
+		return -1;
+
+	fret = f_read(&file, dest, SDCARD_HEADER_SIZE, &byte_read);
+	(void)f_close(&file);
+
+	return (fret == FR_OK) ? 0 : -1;
+}
+#endif
+
 #ifdef CONFIG_OVERRIDE_CMDLINE_FROM_EXT_FILE
 static int sdcard_read_cmd(char *cmdline_file, char *cmdline_args)
 {
@@ -124,6 +147,11 @@ int load_sdcard(struct image_info *image)
 		return -1;
 	}
 
+#if defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
+	if (!sdcard_read_header(image->filename, image->dest))
+		kernel_placement(image);
+#endif
+
 	dbg_info("SD/MMC: Image: Read file %s to %x\n",
 					image->filename, image->dest);
 
@@ -11,6 +11,10 @@
 #include "pmc.h"
 #include "sdhc.h"
 #include "sdhc_cal.h"
+#include "barriers.h"
+#ifdef CONFIG_CACHES
+#include "l1cache.h"
+#endif
 
 /*
  * Registers Definitions
@@ -326,6 +330,33 @@ static void sdhc_software_reset_dat(void)
 		;
 }
 
+/*
+ * Bounds of the register polls, in microseconds. DAT inhibit stays set
+ * while the card signals busy after an R1b command, and an e.MMC may
+ * take up to the largest GENERIC_CMD6_TIME, 255 x 10 ms, for a CMD6.
+ */
+#define SDHC_BUSY_TIMEOUT_US	2550000
+#define SDHC_INHIBIT_TIMEOUT_US	SDHC_BUSY_TIMEOUT_US
+#define SDHC_CLOCK_TIMEOUT_US	20000
+#define SDHC_CMD_TIMEOUT_US	20000
+#define SDHC_TUNE_TIMEOUT_US	5000	/* 40 tries must fit in 150ms */
+#define SDHC_CD_TIMEOUT_US	50000
+#define SDHC_BWRRDY_TIMEOUT_US	1000
+
+static int sdhc_wait_inhibit(void)
+{
+	unsigned long long deadline = deadline_from_us(SDHC_INHIBIT_TIMEOUT_US);
+
+	while (sdhc_readl(SDMMC_PSR) & (SDMMC_PSR_CMDINHC | SDMMC_PSR_CMDINHD)) {
+		if (deadline_expired(deadline)) {
+			dbg_info("SDHC: Timeout waiting for CMD and DAT Inhibit bits\n");
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
 static void sdhc_set_power(void)
 {
 	unsigned char value = sdhc_readb(SDMMC_PCR);
@@ -339,15 +370,9 @@ static int sdhc_set_clock(struct sd_card *sdcard, unsigned int clock)
 	unsigned int clk_gen_sel = 0;
 	unsigned int clk_div;
 	unsigned int reg;
-	unsigned int timeout;
+	unsigned long long deadline;
 
-	timeout = 10000000;
-	while ((--timeout) &&
-	       (sdhc_readl(SDMMC_PSR) & (SDMMC_PSR_CMDINHC | SDMMC_PSR_CMDINHD)))
-		;
-
-	if (!timeout)
-		dbg_info("SDHC: Timeout waiting for CMD and DAT Inhibit bits\n");
+	sdhc_wait_inhibit();
 
 	/* Use this to disable the SD clock */
 	if (!clock) {
@@ -391,12 +416,13 @@ static int sdhc_set_clock(struct sd_card *sdcard, unsigned int clock)
 			| (((clk_div >> 8) & SDMMC_CCR_USDCLKFSEL_MSK)
 					<< SDMMC_CCR_USDCLKFSEL_OFFSET));
 
-	timeout = 1000000;
-	while ((--timeout) && (!(sdhc_readw(SDMMC_CCR) & SDMMC_CCR_INTCLKS)))
-		;
-
-	if (!timeout)
-		dbg_info("SDHC: Timeout waiting for internal clock ready\n");
+	deadline = deadline_from_us(SDHC_CLOCK_TIMEOUT_US);
+	while (!(sdhc_readw(SDMMC_CCR) & SDMMC_CCR_INTCLKS)) {
+		if (deadline_expired(deadline)) {
+			dbg_info("SDHC: Timeout waiting for internal clock ready\n");
+			break;
+		}
+	}
 
 	sdhc_writew(SDMMC_CCR, sdhc_readw(SDMMC_CCR) | SDMMC_CCR_SDCLKEN);
 
@@ -548,25 +574,20 @@ static int sdhc_host_capability(struct sd_card *sdcard)
 
 static int sdhc_send_tune_command(struct sd_card *sdcard, unsigned int size, unsigned int cmd)
 {
-	unsigned int timeout;
+	unsigned long long deadline;
 
 	sdhc_writew(SDMMC_TMR, SDMMC_TMR_DTDSEL_READ);
 	sdhc_writew(SDMMC_BSR, size);
 
-	timeout = 10000000;
-	while ((--timeout) &&
-	       (sdhc_readl(SDMMC_PSR) & (SDMMC_PSR_CMDINHC | SDMMC_PSR_CMDINHD))) ;
-	if (!timeout)
-		dbg_info("SDHC: Timeout waiting for CMD and DAT Inhibit bits\n");
+	sdhc_wait_inhibit();
 
 	sdhc_writel(SDMMC_ARG1R, 0);
 	sdhc_writew(SDMMC_CR, SDMMC_CR_CMDIDX_(cmd) | SDMMC_CR_RESPTYP_RL48 | \
 				SDMMC_CR_CMDCCEN | 	SDMMC_CR_CMDICEN | SDMMC_CR_DPSEL );
-	timeout = 100000;
-	while (--timeout) {
-	   if (sdhc_readw(SDMMC_NISTR) & SDMMC_NISTR_BRDRDY)
-		   break;
-	}
+	deadline = deadline_from_us(SDHC_TUNE_TIMEOUT_US);
+	while (!(sdhc_readw(SDMMC_NISTR) & SDMMC_NISTR_BRDRDY) &&
+	       !deadline_expired(deadline))
+		;
 	sdhc_writew(SDMMC_NISTR, SDMMC_NISTR_BRDRDY);
 	return 0;
 }
@@ -639,11 +660,9 @@ static int sdhc_is_card_inserted(struct sd_card *sdcard)
 	/*
 	 * Debouncing of the card detect pin is up to 13ms on sama5d2 rev B
 	 * and later.
-	 * Try to be safe and wait for up to 50ms (50000µs). Let assume
-	 * the PCK (processor clock) frequency is 500MHz, hence 500 cycles/µs.
-	 * 500 * 50000 = 25000000 cycles.
+	 * Try to be safe and wait for up to 50ms.
 	 */
-	unsigned int timeout = 25000000;
+	unsigned long long deadline;
 	int is_inserted = 0;
 
 	/*
@@ -662,8 +681,10 @@ static int sdhc_is_card_inserted(struct sd_card *sdcard)
 	}
 
 	/* Poll the Normal Interrupt Status Register for bit 'card inserted'. */
+	deadline = deadline_from_us(SDHC_CD_TIMEOUT_US);
 	while (!(sdhc_readw(SDMMC_NISTR) & SDMMC_NISTR_CINS) &&
-	       timeout--);
+	       !deadline_expired(deadline))
+		;
 
 	is_inserted = !!(sdhc_readw(SDMMC_NISTR) & SDMMC_NISTR_CINS);
 
@@ -726,21 +747,97 @@ static int sdhc_init(struct sd_card *sdcard)
 	return 0;
 }
 
+/*
+ * Data transfer completion. The status is polled back to back while the
+ * transfer makes progress; only once it has stalled for a while does the
+ * loop start to sleep between polls, with a growing interval. The timeout
+ * is measured with the timer and restarts on every sign of progress, so
+ * it bounds a stall rather than the length of the whole transfer.
+ */
+#define SDHC_POLL_SPINS		256	/* busy polls before backing off */
+#define SDHC_POLL_MAX_DELAY	16	/* us */
+#define SDHC_DATA_TIMEOUT_US	(CONFIG_SDHC_DATA_TIMEOUT * 1000)
+
+struct sdhc_poll {
+	unsigned long long deadline;
+	unsigned int idle;
+	unsigned int delay;
+};
+
+static void sdhc_poll_start(struct sdhc_poll *poll)
+{
+	poll->deadline = deadline_from_us(SDHC_DATA_TIMEOUT_US);
+	poll->idle = 0;
+	poll->delay = 1;
+}
+
+/* Account for one poll, returns -1 once the transfer has timed out */
+static int sdhc_poll_wait(struct sdhc_poll *poll, int progress)
+{
+	if (progress) {
+		sdhc_poll_start(poll);
+		return 0;
+	}
+
+	if (++poll->idle < SDHC_POLL_SPINS)
+		return 0;
+
+	if (deadline_expired(poll->deadline))
+		return -1;
+
+	udelay(poll->delay);
+	if (poll->delay < SDHC_POLL_MAX_DELAY)
+		poll->delay <<= 1;
+
+	return 0;
+}
+
+static void sdhc_pio_block(struct sd_data *data)
+{
+	unsigned int fifo = sdhc_get_base() + SDMMC_BDPR;
+	unsigned int *buf = (unsigned int *)data->buff;
+	unsigned int words = data->blocksize >> 2;
+
+	if (data->direction == SD_DATA_DIR_RD) {
+		for (; words >= 4; words -= 4, buf += 4) {
+			buf[0] = readl(fifo);
+			buf[1] = readl(fifo);
+			buf[2] = readl(fifo);
+			buf[3] = readl(fifo);
+		}
+		while (words--)
+			*buf++ = readl(fifo);
+	} else {
+		for (; words >= 4; words -= 4, buf += 4) {
+			writel(buf[0], fifo);
+			writel(buf[1], fifo);
+			writel(buf[2], fifo);
+			writel(buf[3], fifo);
+		}
+		while (words--)
+			writel(*buf++, fifo);
+	}
+
+	data->buff += data->blocksize;
+}
+
 static int sdhc_read_data(struct sd_data *data)
 {
 	unsigned short normal_status, error_status;
-	unsigned int psr;
-	unsigned int timeout;
+	unsigned int bufen;
 	unsigned int block = 0;
-	unsigned short i;
-	unsigned int *tmp;
-	int done = 0;
+	unsigned int last_block;
+	struct sdhc_poll poll;
+	int ret = -1;
+
+	bufen = (data->direction == SD_DATA_DIR_RD) ?
+		SDMMC_PSR_BUFRDEN : SDMMC_PSR_BUFWREN;
 
-	timeout = 100000;
+	sdhc_poll_start(&poll);
 	do {
 		normal_status = sdhc_readw(SDMMC_NISTR);
-
-		sdhc_writew(SDMMC_NISTR, normal_status);
+		if (normal_status)
+			sdhc_writew(SDMMC_NISTR, normal_status);
 
 		if ((normal_status & SDMMC_NISTR_ERRINT) == SDMMC_NISTR_ERRINT) {
 			error_status = sdhc_readw(SDMMC_EISTR);
@@ -754,40 +851,30 @@ static int sdhc_read_data(struct sd_data *data)
 
 			return -1;
 		}
-		if (((normal_status & SDMMC_NISTR_BRDRDY) ||
-			(normal_status & SDMMC_NISTR_BWRRDY)) && !done ) {
-			psr = sdhc_readl(SDMMC_PSR);
-			if (data->direction == SD_DATA_DIR_RD &&
-				!(psr & SDMMC_PSR_BUFRDEN))
-			continue;
-			if (data->direction == SD_DATA_DIR_WR &&
-				!(psr & SDMMC_PSR_BUFWREN))
-			continue;
-
-			tmp = (unsigned int *)data->buff;
-			for (i = 0; i < data->blocksize; i += 4) {
-				if (data->direction == SD_DATA_DIR_RD)
-					*tmp++ = sdhc_readl(SDMMC_BDPR);
-				else
-					sdhc_writel(SDMMC_BDPR, *tmp++);
-			}
 
-			data->buff += data->blocksize;
-			if (++block >= data->blocks) {
-				done = 1;
-				goto sdhc_read_data_reset;
-			}
+		/* move every block the buffer is ready for, not just one */
+		last_block = block;
+		while (block < data->blocks && (sdhc_readl(SDMMC_PSR) & bufen)) {
+			sdhc_pio_block(data);
+			block++;
 		}
 
-		if (timeout-- > 0) {
-			udelay(10);
-		} else {
+		if (block >= data->blocks) {
+			ret = 0;
+			goto sdhc_read_data_reset;
+		}
+
+		if (sdhc_poll_wait(&poll, block != last_block)) {
 			dbg_loud("SDHC: Transfer data timeout\n");
 			goto sdhc_read_data_reset;
 		}
-	} while (!(normal_status & SDMMC_NISTR_TRFC) && !done);
+	} while (!(normal_status & SDMMC_NISTR_TRFC));
 
-	return 0;
+	/* completed with blocks still missing */
+	dbg_info("SDHC: Transfer ended after %u of %u blocks\n",
+		 block, data->blocks);
+
+	return -1;
 
 sdhc_read_data_reset:
 	/* There is an issue when writing data,
@@ -800,10 +887,12 @@ sdhc_read_data_reset:
 	if (data->direction == SD_DATA_DIR_WR &&
 		(sdhc_readl(SDMMC_PSR) & SDMMC_PSR_WTACT)) {
 		/* wait for BWRRDY to be cleared */
-		unsigned int timeout2 = 10000;
+		unsigned long long deadline =
+			deadline_from_us(SDHC_BWRRDY_TIMEOUT_US);
 		do {
 			normal_status = sdhc_readw(SDMMC_NISTR);
-		} while (timeout2-- && (normal_status & SDMMC_NISTR_BWRRDY));
+		} while ((normal_status & SDMMC_NISTR_BWRRDY) &&
+			 !deadline_expired(deadline));
 	}
 
 	error_status = sdhc_readw(SDMMC_EISTR);
@@ -812,7 +901,114 @@ sdhc_read_data_reset:
 	sdhc_writew(SDMMC_EISTR, error_status);
 	sdhc_writew(SDMMC_NISTR, normal_status);
 
-	return -1;
+	/* the last block may still have been flagged after it was moved */
+	if (error_status & (SDMMC_EISTR_DATCRC | SDMMC_EISTR_DATEND)) {
+		dbg_info("SDHC: Error detected in status: %x, %x\n",
+			 normal_status, error_status);
+		ret = -1;
+	}
+
+	return ret;
+}
+
+/*
+ * ADMA2 descriptor ring. It lives in SRAM for the whole boot, and its
+ * last slot is a link descriptor back to the first one, so a single
+ * CMD18 can move far more data than the ring describes at once: while
+ * the transfer runs, sdhc_adma2_refill() recycles the slots the
+ * controller is done with. The slot after the last filled one is
+ * always left invalid, so that the ADMA stops with an error rather
+ * than replaying a stale descriptor if it ever catches up.
+ */
+#define ADMA2_LINK_SLOT		(ADMA2_MAX_NUM_DESC - 1)
+
+static struct adma_desc adma2_ring[ADMA2_MAX_NUM_DESC];
+
+static struct {
+	unsigned char *buff;	/* next address to describe */
+	unsigned int remain;	/* bytes not described yet */
+	unsigned int head;	/* next slot to fill */
+} adma2_stream;
+
+static unsigned int adma2_next_slot(unsigned int slot)
+{
+	return (++slot == ADMA2_LINK_SLOT) ? 0 : slot;
+}
+
+static unsigned int adma2_prev_slot(unsigned int slot)
+{
+	return slot ? slot - 1 : ADMA2_LINK_SLOT - 1;
+}
+
+/* Slot the ADMA will fetch next, the one before it may be in progress */
+static unsigned int adma2_fetch_slot(void)
+{
+	unsigned int slot = (sdhc_readl(SDMMC_ASAR0)
+				- (unsigned int)adma2_ring) / sizeof(struct adma_desc);
+
+	return (slot >= ADMA2_LINK_SLOT) ? 0 : slot;
+}
+
+static void adma2_fill_slot(unsigned int slot)
+{
+	struct adma_desc *desc = &adma2_ring[slot];
+	unsigned int len = adma2_stream.remain;
+	unsigned short attr = ADMA2_ATTR_ACT_TRAN | ADMA2_ATTR_VALID;
+
+	if (len > ADMA2_DESC_MAX_LEN)
+		len = ADMA2_DESC_MAX_LEN;
+
+	adma2_stream.remain -= len;
+	if (!adma2_stream.remain)
+		attr |= ADMA2_ATTR_END;
+
+	desc->addr = (unsigned int)adma2_stream.buff;
+	desc->len = len & 0xffff;
+	adma2_stream.buff += len;
+
+	/* the attributes validate the descriptor, they go last */
+	dmb();
+	desc->cmd = attr;
+}
+
+/*
+ * Describe as much of the remaining data as the free slots allow,
+ * keeping an invalid guard slot ahead of the last filled one.
+ */
+static void sdhc_adma2_refill(unsigned int fetch)
+{
+	unsigned int busy = adma2_prev_slot(fetch);
+	unsigned int next;
+
+	while (adma2_stream.remain) {
+		next = adma2_next_slot(adma2_stream.head);
+		if (next == busy || next == fetch)
+			break;
+
+		adma2_ring[next].cmd = 0;
+		dmb();
+		adma2_fill_slot(adma2_stream.head);
+		adma2_stream.head = next;
+	}
+
+	dsb();
+}
+
+static void sdhc_adma2_prepare(struct sd_data *data)
+{
+	adma2_stream.buff = data->buff;
+	adma2_stream.remain = data->blocks * data->blocksize;
+	adma2_stream.head = 0;
+
+	adma2_ring[ADMA2_LINK_SLOT].addr = (unsigned int)adma2_ring;
+	adma2_ring[ADMA2_LINK_SLOT].len = 0;
+	adma2_ring[ADMA2_LINK_SLOT].cmd = ADMA2_ATTR_ACT_LINK
+					| ADMA2_ATTR_VALID;
+
+	sdhc_adma2_refill(0);
+
+	/* address of the first descriptor goes here */
+	sdhc_writel(SDMMC_ASAR0, (unsigned int)adma2_ring);
 }
 
 static int sdhc_send_command(struct sd_command *sd_cmd, struct sd_data *data)
@@ -821,18 +1017,11 @@ static int sdhc_send_command(struct sd_command *sd_cmd, struct sd_data *data)
 	unsigned int cmd_reg, mode;
 	unsigned int i;
 	int ret;
-	unsigned int timeout;
-	struct adma_desc dma_desc[ADMA2_MAX_NUM_DESC] = {0};
-	unsigned int blocks_remain;
-	unsigned int offset;
-
-	timeout = 0x10000000;
-	while ((--timeout) &&
-	       (sdhc_readl(SDMMC_PSR) & (SDMMC_PSR_CMDINHC | SDMMC_PSR_CMDINHD)))
-		;
+	unsigned long long deadline;
+	unsigned int fetch, last_fetch;
+	struct sdhc_poll poll;
 
-	if (!timeout)
-		dbg_info("SDHC: Timeout waiting for CMD and DAT Inhibit bits\n");
+	sdhc_wait_inhibit();
 
 	normal_status_mask =  SDMMC_NISTR_CMDC;
 
@@ -888,28 +1077,17 @@ static int sdhc_send_command(struct sd_command *sd_cmd, struct sd_data *data)
 		/* for CMD17 and CMD18 we use ADMA to transfer faster */
 		if (sdhc_host.caps_adma2 && (sd_cmd->cmd == SD_CMD_READ_SINGLE_BLOCK ||
 		    sd_cmd->cmd == SD_CMD_READ_MULTIPLE_BLOCK)) {
-			/* prepare descriptor table */
-			if (data->blocks > ADMA2_MAX_NUM_DESC * ADMA2_MAX_DESC_BLOCKS)
-				dbg_printf("too many blocks requested at once, error\n");
-			blocks_remain = data->blocks;
-			offset = 0;
-			for (i = 0;; i++) {
-				if (blocks_remain > ADMA2_MAX_DESC_BLOCKS) {
-					dma_desc[i].len = 0;
-					blocks_remain -= ADMA2_MAX_DESC_BLOCKS;
-					dma_desc[i].cmd = 0x21;
-					dma_desc[i].addr = (unsigned int)(data->buff + offset);
-					offset += ADMA2_MAX_DESC_BLOCKS * 512;
-				} else {
-					dma_desc[i].len = blocks_remain * 512;
-					/* last descriptor must have the end bit */
-					dma_desc[i].cmd = 0x23;
-					dma_desc[i].addr = (unsigned int)(data->buff + offset);
-					break;
-				}
-			}
-		/* address of the first descriptor goes here */
-		sdhc_writel(SDMMC_ASAR0, (unsigned int) &dma_desc[0]);
+#ifdef CONFIG_CACHES
+			/*
+			 * The buffer ends need not be on cache lines: write
+			 * back the lines it shares with data the CPU owns, so
+			 * that no dirty line lands over the DMA data later.
+			 */
+			dcache_clean_region((unsigned int)data->buff,
+					    (unsigned int)data->buff
+					    + data->blocks * data->blocksize);
+#endif
+			sdhc_adma2_prepare(data);
 		}
 	}
 
@@ -917,13 +1095,16 @@ static int sdhc_send_command(struct sd_command *sd_cmd, struct sd_data *data)
 
 	sdhc_writew(SDMMC_CR, cmd_reg);
 
-	timeout = 400000;
+	/* with R1b, the transfer completes when the card is no longer busy */
+	deadline = deadline_from_us((sd_cmd->resp_type == SD_RESP_TYPE_R1B) ?
+				    SDHC_BUSY_TIMEOUT_US : SDHC_CMD_TIMEOUT_US);
 	do {
 		normal_status = sdhc_readw(SDMMC_NISTR);
-	} while ((--timeout) &&
-		 ((normal_status & normal_status_mask) != normal_status_mask));
+		if ((normal_status & normal_status_mask) == normal_status_mask)
+			break;
+	} while (!deadline_expired(deadline));
 
-	if (!timeout)
+	if ((normal_status & normal_status_mask) != normal_status_mask)
 		dbg_very_loud("SDHC: Timeout waiting for command complete\n");
 
 	if ((normal_status & normal_status_mask) == normal_status_mask) {
@@ -934,26 +1115,56 @@ static int sdhc_send_command(struct sd_command *sd_cmd, struct sd_data *data)
 			*sd_cmd->resp = sdhc_readl(SDMMC_RR0);
 		}
 
+		ret = 0;
+
 		/* if we have data but not using block transfer, we use PIO mode */
 		if (data && (!sdhc_host.caps_adma2 || (sd_cmd->cmd != SD_CMD_READ_SINGLE_BLOCK &&
 		    sd_cmd->cmd != SD_CMD_READ_MULTIPLE_BLOCK))) {
-			sdhc_read_data(data);
+			ret = sdhc_read_data(data);
 		} else if (data && sdhc_host.caps_adma2) {
 			/* otherwise, ADMA will carry the data for us */
-			/* Let's wait for ADMA to finish transferring */
-			timeout = 1000000;
+			/* Let's wait for ADMA to finish transferring, feeding
+			 * the descriptor ring as it goes.
+			 */
+			last_fetch = 0;
+			sdhc_poll_start(&poll);
 			do {
 				normal_status = sdhc_readw(SDMMC_NISTR);
-				udelay(1);
-			} while (--timeout && !(normal_status & SDMMC_NISTR_TRFC));
-			if (!timeout)
-				console_printf("SDHC: Timeout waiting for ADMA\n");
+				if (normal_status & (SDMMC_NISTR_TRFC | SDMMC_NISTR_ERRINT))
+					break;
+
+				fetch = adma2_fetch_slot();
+				if (adma2_stream.remain)
+					sdhc_adma2_refill(fetch);
+
+				ret = sdhc_poll_wait(&poll, fetch != last_fetch);
+				last_fetch = fetch;
+			} while (!ret);
 
 			sdhc_writew(SDMMC_NISTR, SDMMC_NISTR_TRFC);
-			error_status = sdhc_readw(SDMMC_EISTR);
-		}
 
-		ret = 0;
+#ifdef CONFIG_CACHES
+			/* drop what the cache read from the buffer meanwhile */
+			dcache_invalidate_region((unsigned int)data->buff,
+						 (unsigned int)data->buff
+						 + data->blocks * data->blocksize);
+#endif
+
+			/* a transfer stopped early or corrupted is not a read */
+			if (ret || (normal_status & SDMMC_NISTR_ERRINT)) {
+				if (ret)
+					console_printf("SDHC: Timeout waiting for ADMA\n");
+				else
+					console_printf("SDHC: ADMA error: %x\n",
+						       sdhc_readw(SDMMC_AESR));
+
+				error_status = sdhc_readw(SDMMC_EISTR);
+				sdhc_writew(SDMMC_EISTR, error_status);
+				sdhc_software_reset_dat();
+
+				ret = -1;
+			}
+		}
 	} else {
 		error_status = sdhc_readw(SDMMC_EISTR);
 
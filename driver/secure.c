@@ -69,24 +69,24 @@ void ocms_enable(void)
 
 #endif /* #if defined(CONFIG_OCMS_STATIC) */
 
-static int secure_decrypt(void *data, unsigned int data_length, int is_signed)
-{
-	at91_aes_key_size_t key_size;
-	unsigned int computed_cmac[AT91_AES_BLOCK_SIZE_WORD];
-	unsigned int fixed_length;
-	const unsigned int *cmac;
-	int rc = -1;
-
 #if defined(CONFIG_AES_KEY_SIZE_128)
-	key_size = AT91_AES_KEY_SIZE_128;
+#define SECURE_KEY_SIZE		AT91_AES_KEY_SIZE_128
 #elif defined(CONFIG_AES_KEY_SIZE_192)
-	key_size = AT91_AES_KEY_SIZE_192;
+#define SECURE_KEY_SIZE		AT91_AES_KEY_SIZE_192
 #elif defined(CONFIG_AES_KEY_SIZE_256)
-	key_size = AT91_AES_KEY_SIZE_256;
+#define SECURE_KEY_SIZE		AT91_AES_KEY_SIZE_256
 #else
 #error "bad AES key size"
 #endif
 
+static int secure_decrypt(void *data, unsigned int data_length, int is_signed)
+{
+	at91_aes_key_size_t key_size = SECURE_KEY_SIZE;
+	unsigned int computed_cmac[AT91_AES_BLOCK_SIZE_WORD];
+	unsigned int fixed_length;
+	const unsigned int *cmac;
+	int rc = -1;
+
 	/* Init periph */
 	at91_aes_init();
 
@@ -125,12 +125,204 @@ static void __attribute__((optimize("O0"))) wipe_keys()
 	memset(iv, 0, sizeof(iv));
 }
 
+#ifdef CONFIG_SECURE_STREAM
+/*
+ * Streaming check: the loaders report how much of the image has landed
+ * in memory, and every new chunk is authenticated and decrypted in place
+ * while it is still hot in the caches, instead of walking the whole file
+ * twice once it is loaded. The CMAC is chained across the chunks, the
+ * last block is kept for secure_check() which completes the CMAC and
+ * compares it with the one appended to the file.
+ */
+enum secure_stream_state {
+	SECURE_STREAM_IDLE,
+	SECURE_STREAM_HEADER,	/* waiting for the header */
+	SECURE_STREAM_FILE,	/* header checked, processing the file */
+	SECURE_STREAM_FAILED,
+};
+
+static struct {
+	enum secure_stream_state state;
+	unsigned char *base;
+	unsigned char *file;
+	unsigned int file_size;	/* rounded up to the AES block size */
+	unsigned int loaded;	/* high watermark reported by the loader */
+	unsigned int done;	/* bytes of the file MACed and decrypted */
+	unsigned int mac[AT91_AES_BLOCK_SIZE_WORD];
+	unsigned int iv[AT91_AES_IV_SIZE_WORD];
+} stream;
+
+static void secure_stream_reset(void)
+{
+	stream.state = SECURE_STREAM_HEADER;
+	stream.file = stream.base + sizeof(at91_secure_header_t);
+	stream.file_size = 0;
+	stream.loaded = 0;
+	stream.done = 0;
+	memset(stream.mac, 0, sizeof(stream.mac));
+	memcpy(stream.iv, iv, sizeof(stream.iv));
+}
+
+static int secure_stream_header(void)
+{
+	const at91_secure_header_t *header =
+		(const at91_secure_header_t *)stream.base;
+
+	if (at91_aes_cbc(sizeof(*header), stream.base, stream.base, 0,
+			 SECURE_KEY_SIZE, cipher_key, iv))
+		return -1;
+
+	if (header->magic != AT91_SECURE_MAGIC || !header->file_size)
+		return -1;
+
+	stream.file_size = at91_aes_roundup(header->file_size);
+	stream.state = SECURE_STREAM_FILE;
+
+	return 0;
+}
+
+/* MAC then decrypt the whole blocks of [done, end) */
+static int secure_stream_blocks(unsigned int end)
+{
+	unsigned int next_iv[AT91_AES_IV_SIZE_WORD];
+	unsigned char *data = stream.file + stream.done;
+	unsigned int length = end - stream.done;
+
+	if (at91_aes_cbc_mac(length, data, stream.mac,
+			     SECURE_KEY_SIZE, cmac_key, stream.mac))
+		return -1;
+
+	/* the in-place decryption eats the ciphertext of the next IV */
+	memcpy(next_iv, data + length - AT91_AES_BLOCK_SIZE_BYTE,
+	       sizeof(next_iv));
+	if (at91_aes_cbc(length, data, data, 0,
+			 SECURE_KEY_SIZE, cipher_key, stream.iv))
+		return -1;
+	memcpy(stream.iv, next_iv, sizeof(stream.iv));
+
+	stream.done = end;
+
+	return 0;
+}
+
+static int secure_stream_advance(unsigned int loaded)
+{
+	unsigned int end;
+
+	if (stream.state == SECURE_STREAM_HEADER) {
+		if (loaded < sizeof(at91_secure_header_t))
+			return 0;
+
+		if (secure_stream_header())
+			return -1;
+	}
+
+	/* the last block goes through the CMAC finalization */
+	end = loaded - sizeof(at91_secure_header_t);
+	if (end > stream.file_size - AT91_AES_BLOCK_SIZE_BYTE)
+		end = stream.file_size - AT91_AES_BLOCK_SIZE_BYTE;
+	end &= ~(AT91_AES_BLOCK_SIZE_BYTE - 1);
+
+	if (end <= stream.done)
+		return 0;
+
+	return secure_stream_blocks(end);
+}
+
+void secure_stream_start(void *data)
+{
+	stream.base = data;
+	secure_stream_reset();
+
+	at91_aes_init();
+}
+
+void secure_stream_update(void *data, unsigned int loaded)
+{
+	if ((unsigned char *)data != stream.base)
+		return;
+
+	if (stream.state == SECURE_STREAM_IDLE)
+		return;
+
+	/* the loader started over, the plaintext has been overwritten */
+	if (loaded < stream.loaded)
+		secure_stream_reset();
+	stream.loaded = loaded;
+
+	if (stream.state == SECURE_STREAM_FAILED)
+		return;
+
+	if (secure_stream_advance(loaded))
+		stream.state = SECURE_STREAM_FAILED;
+}
+
+static void secure_stream_end(int rc)
+{
+	/* never leave plaintext of an image that failed the check */
+	if (rc && stream.done)
+		memset(stream.file, 0, stream.done);
+
+	memset(&stream, 0, sizeof(stream));
+	at91_aes_cleanup();
+}
+
+static int secure_stream_finish(void)
+{
+	unsigned int computed_cmac[AT91_AES_BLOCK_SIZE_WORD];
+	const unsigned int *cmac;
+	unsigned char *last;
+	int rc = -1;
+
+	/* the whole image is in memory now */
+	if (stream.state == SECURE_STREAM_FAILED ||
+	    secure_stream_advance(0xffffffff))
+		goto exit;
+
+	last = stream.file + stream.done;
+	memcpy(computed_cmac, stream.mac, sizeof(computed_cmac));
+	if (at91_aes_cmac_final((const unsigned int *)last, computed_cmac,
+				SECURE_KEY_SIZE, cmac_key))
+		goto exit;
+
+	cmac = (const unsigned int *)(stream.file + stream.file_size);
+	if (!consttime_memequal(cmac, computed_cmac, AT91_AES_BLOCK_SIZE_BYTE))
+		goto exit;
+
+	if (at91_aes_cbc(AT91_AES_BLOCK_SIZE_BYTE, last, last, 0,
+			 SECURE_KEY_SIZE, cipher_key, stream.iv))
+		goto exit;
+
+	rc = 0;
+exit:
+	secure_stream_end(rc);
+
+	return rc;
+}
+
+void secure_stream_abort(void)
+{
+	if (stream.state == SECURE_STREAM_IDLE)
+		return;
+
+	secure_stream_end(-1);
+	wipe_keys();
+}
+#endif /* #ifdef CONFIG_SECURE_STREAM */
+
 int secure_check(void *data)
 {
 	const at91_secure_header_t *header;
 	void *file;
 	int ret = -1;
 
+#ifdef CONFIG_SECURE_STREAM
+	if (stream.state != SECURE_STREAM_IDLE && data == stream.base) {
+		ret = secure_stream_finish();
+		goto secure_wipe_keys;
+	}
+#endif
+
 	if (secure_decrypt(data, sizeof(*header), 0))
 		goto secure_wipe_keys;
 
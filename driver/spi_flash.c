@@ -10,8 +10,10 @@
 #include "gpio.h"
 #include "string.h"
 #include "timer.h"
+#include "bootstage.h"
 #include "div.h"
 #include "fdt.h"
+#include "secure.h"
 #include "debug.h"
 
 /* Manufacturer Device ID Read */
@@ -67,6 +69,7 @@ static int df_send_command(unsigned char *cmd,
 				unsigned char *data,
 				unsigned int data_len)
 {
+	int ret;
 	int i;
 
 	if (!cmd)
@@ -89,13 +92,11 @@ static int df_send_command(unsigned char *cmd,
 		at91_spi_read_spi();
 	}
 
-	for (i = 0; i < data_len; i++) {
-		at91_spi_write_data(0);
-		*data++ = at91_spi_read_spi();
-	}
+	ret = at91_spi_read_bulk(data, data_len);
+
 	at91_spi_cs_deactivate();
 
-	return 0;
+	return ret;
 }
 
 static int dataflash_read_array(struct dataflash_descriptor *df_desc,
@@ -181,6 +182,32 @@ static int read_array(struct dataflash_descriptor *df_desc,
 		return spinor_read_array(df_desc, offset, len, buf);
 }
 
+/* read the image by chunks, for the secure check to follow the load */
+static int read_image(struct dataflash_descriptor *df_desc,
+				unsigned int offset,
+				unsigned int len,
+				unsigned char *buf)
+{
+	unsigned int chunk, done = 0;
+	int ret;
+
+	secure_stream_update(buf, 0);
+	while (done < len) {
+		chunk = len - done;
+		if (chunk > SECURE_STREAM_CHUNK)
+			chunk = SECURE_STREAM_CHUNK;
+
+		ret = read_array(df_desc, offset + done, chunk, buf + done);
+		if (ret)
+			return ret;
+
+		done += chunk;
+		secure_stream_update(buf, done);
+	}
+
+	return 0;
+}
+
 #if defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
 static int update_image_length(struct dataflash_descriptor *df_desc,
 				unsigned int offset,
@@ -670,6 +697,7 @@ int spi_flash_loadimage(struct image_info *image)
 		goto err_exit;
 	}
 #endif
+	bootstage_mark(BOOTSTAGE_MEDIA_INIT);
 
 #if defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
 	int length = update_image_length(df_desc,
@@ -678,12 +706,13 @@ int spi_flash_loadimage(struct image_info *image)
 		return -1;
 
 	image->length = length;
+	kernel_placement(image);
 #endif
 
 	dbg_info("SF: Copy %x bytes from %x to %x\n",
 			image->length, image->offset, image->dest);
 
-	ret = read_array(df_desc, image->offset, image->length, image->dest);
+	ret = read_image(df_desc, image->offset, image->length, image->dest);
 	if (ret) {
 		dbg_info("** SF: Serial flash read error**\n");
 		ret = -1;
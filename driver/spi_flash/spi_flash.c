@@ -10,6 +10,7 @@
 #include "timer.h"
 #include "div.h"
 #include "fdt.h"
+#include "secure.h"
 
 int spi_flash_read_reg(struct spi_flash *flash, u8 inst, u8 *buf, size_t len)
 {
@@ -286,6 +287,32 @@ int spi_flash_recovery(struct spi_flash *flash)
 }
 #endif /* CONFIG_DATAFLASH_RECOVERY */
 
+#ifndef CONFIG_QSPI_XIP
+/* read the image by chunks, for the secure check to follow the load */
+static int spi_flash_read_image(struct spi_flash *flash, size_t from,
+				size_t len, u8 *buf)
+{
+	size_t chunk, done = 0;
+	int ret;
+
+	secure_stream_update(buf, 0);
+	while (done < len) {
+		chunk = len - done;
+		if (chunk > SECURE_STREAM_CHUNK)
+			chunk = SECURE_STREAM_CHUNK;
+
+		ret = spi_flash_read(flash, from + done, chunk, buf + done);
+		if (ret)
+			return ret;
+
+		done += chunk;
+		secure_stream_update(buf, done);
+	}
+
+	return 0;
+}
+#endif
+
 int spi_flash_loadimage(struct spi_flash *flash, struct image_info *image)
 {
 #if defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
@@ -348,14 +375,15 @@ int spi_flash_loadimage(struct spi_flash *flash, struct image_info *image)
 	}
 
 	image->length = length;
+	kernel_placement(image);
 #endif
 
 	dbg_info("SF: Copy %x bytes from %x to %x\n",
 		 image->length, image->offset, image->dest);
-	ret = spi_flash_read(flash,
-			     image->offset,
-			     image->length,
-			     image->dest);
+	ret = spi_flash_read_image(flash,
+				   image->offset,
+				   image->length,
+				   image->dest);
 	if (ret) {
 		dbg_info("** SF: Serial flash read error**\n");
 		ret = -1;
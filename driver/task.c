@@ -0,0 +1,107 @@
+// Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+//
+// SPDX-License-Identifier: MIT
+
+#include "common.h"
+#include "task.h"
+#include "timer.h"
+#include "debug.h"
+
+#define TASK_IDLE	0
+#define TASK_PENDING	1
+#define TASK_FINISHED	2
+
+static struct task *task_list;
+static int task_running;
+
+static void task_finish(struct task *task)
+{
+	struct task **link;
+
+	for (link = &task_list; *link; link = &(*link)->next) {
+		if (*link == task) {
+			*link = task->next;
+			break;
+		}
+	}
+
+	task->next = NULL;
+	task->status = TASK_FINISHED;
+	dbg_very_loud("TASK: %s done\n", task->name);
+}
+
+/* Run one step of every task whose wake time has come */
+static void task_yield(void)
+{
+	struct task *task, *next;
+
+	/* a step that waits must not run the other ones */
+	if (task_running)
+		return;
+
+	task_running = 1;
+
+	for (task = task_list; task; task = next) {
+		next = task->next;
+		if (!deadline_expired(task->wake))
+			continue;
+
+		if (task->step(task) == TASK_DONE)
+			task_finish(task);
+	}
+
+	task_running = 0;
+}
+
+void task_start(struct task *task)
+{
+	if (task->status == TASK_PENDING)
+		return;
+
+	task->state = 0;
+	task->status = TASK_PENDING;
+
+	if (task->step(task) == TASK_DONE) {
+		task->status = TASK_FINISHED;
+		return;
+	}
+
+	task->next = task_list;
+	task_list = task;
+}
+
+void task_wait(struct task *task)
+{
+	if (task->status == TASK_IDLE)
+		task_start(task);
+
+	while (task->status == TASK_PENDING)
+		task_yield();
+}
+
+void task_wait_all(void)
+{
+	while (task_list)
+		task_yield();
+}
+
+/*
+ * Wait for at least @usec, running the pending tasks meanwhile. A step
+ * may take longer than the time left, so this is only for the waits
+ * that have no upper bound.
+ */
+void task_delay(unsigned int usec)
+{
+#ifdef CONFIG_BOOT_TASKS
+	unsigned long long deadline = deadline_from_us(usec);
+
+	while (!deadline_expired(deadline))
+		task_yield();
+#else
+	unsigned long long deadline = deadline_from_us(usec);
+
+	/* unlike udelay(), this lets the idle hook run */
+	while (!deadline_expired(deadline))
+		;
+#endif
+}
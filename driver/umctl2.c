@@ -4,6 +4,7 @@
 
 #include "backup.h"
 #include "board.h"
+#include "common.h"
 #include "debug.h"
 #include "hardware.h"
 #include "timer.h"
@@ -830,9 +831,50 @@ inline static void uddrc_config_odt_timings()
  * The driver will initialize the Controller and then turn back control.
  * state is useless after this call returns.
  */
+/*
+ * Write a few patterns that toggle every DQ line of each byte lane, then
+ * read them back. This catches DQS gating and read valid latencies that
+ * are off by a clock, which the restored training results could be.
+ */
+static int umctl2_check_dram(void)
+{
+	volatile unsigned int *dram = (volatile unsigned int *)AT91C_BASE_DDRCS;
+	static const unsigned int patterns[] = {
+		0x00000000, 0xffffffff, 0x55555555, 0xaaaaaaaa,
+		0x0f0f0f0f, 0xf0f0f0f0, 0x01234567, 0xfedcba98,
+	};
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(patterns); i++)
+		dram[i] = patterns[i];
+
+	for (i = 0; i < 32; i++)
+		dram[ARRAY_SIZE(patterns) + i] = 1UL << i;
+
+	for (i = 0; i < ARRAY_SIZE(patterns); i++)
+		if (dram[i] != patterns[i])
+			return -1;
+
+	for (i = 0; i < 32; i++)
+		if (dram[ARRAY_SIZE(patterns) + i] != 1UL << i)
+			return -1;
+
+	return 0;
+}
+
+/* Returns 1 when the training results of a previous boot are in use */
+static int umctl2_restore_training(struct umctl2_config_state *state)
+{
+	if (backup_resume() || !state->phy_restore_training)
+		return 0;
+
+	return !state->phy_restore_training();
+}
+
 int umctl2_init (struct umctl2_config_state *state)
 {
 	unsigned int ret = 0;
+	int restored;
 
 #ifndef CONFIG_SYS_BASE_UMCTL2
 #error "CONFIG_SYS_BASE_UMCTL2 undefined"
@@ -1058,11 +1100,14 @@ int umctl2_init (struct umctl2_config_state *state)
 	WAIT_WHILE_COND((UDDRC_REGS->UDDRC_SWSTAT != UDDRC_SWSTAT_sw_done_ack), 0xA6);
 
 	/* STEP 12
-	 * Train PHY
+	 * Train PHY, unless the results of a previous boot can be reused
 	 */
-	ret = state->phy_train();
-	if (ret)
-		return ret;
+	restored = umctl2_restore_training(state);
+	if (!restored) {
+		ret = state->phy_train();
+		if (ret)
+			return ret;
+	}
 
 	if (backup_resume()) {
 		if (state->phy_train_corrupted_data_restore)
@@ -1097,6 +1142,24 @@ int umctl2_init (struct umctl2_config_state *state)
 	if (umctl2_config->axi_port_bitmap &  MP_AXI_PORT_ENABLE(4))
 		UDDRC_MP->UDDRC_PCTRL_4	= UDDRC_PCTRL_4_port_en;
 
+	if (state->phy_save_training && !backup_resume()) {
+		if (umctl2_check_dram()) {
+			if (!restored) {
+				dbg_info("UMCTL2: DRAM check failed.\n");
+				return -1;
+			}
+
+			/* start over with a full training */
+			dbg_info("UMCTL2: Restored training rejected.\n");
+			state->phy_drop_training();
+
+			return umctl2_init(state);
+		}
+
+		if (!restored)
+			state->phy_save_training();
+	}
+
 	return ret;
 }
 
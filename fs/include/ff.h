@@ -205,6 +205,7 @@ typedef enum {
 FRESULT f_mount (BYTE, FATFS*);					/* Mount/Unmount a logical drive */
 FRESULT f_open (FIL*, const TCHAR*, BYTE);			/* Open or create a file */
 FRESULT f_read (FIL*, void*, UINT, UINT*);			/* Read data from a file */
+FRESULT f_load_contiguous (FIL*, void*, DWORD, DWORD*);		/* Read data from a file in as few disk accesses as possible */
 FRESULT f_lseek (FIL*, DWORD);					/* Move file pointer of a file object */
 FRESULT f_close (FIL*);						/* Close an open file object */
 FRESULT f_opendir (DIR*, const TCHAR*);				/* Open an existing directory */
@@ -50,6 +50,19 @@ DRESULT disk_read(BYTE drv,     /* Physical drive number (0..) */
                   DWORD sector, /* Start sector number (LBA) */
                   BYTE count    /* Sector count (1..255) */
     )
+{
+	return disk_read_blocks(drv, buff, sector, count);
+}
+
+/*-----------------------------------------------------------------------*/
+/* Read Sector(s), without the 255 sectors limit of disk_read()          */
+/*-----------------------------------------------------------------------*/
+
+DRESULT disk_read_blocks(BYTE drv,     /* Physical drive number (0..) */
+                         BYTE *buff,   /* Data buffer to store read data */
+                         DWORD sector, /* Start sector number (LBA) */
+                         DWORD count   /* Sector count */
+    )
 {
 	if (drv || !count) return RES_PARERR;
 	if (Stat & STA_NOINIT) return RES_NOTRDY;
@@ -94,6 +94,7 @@
 
 #include "ff.h"		/* FatFs configurations and declarations */
 #include "diskio.h"	/* Declarations of low level disk I/O functions */
+#include "div.h"	/* Integer division without libgcc */
 
 /*--------------------------------------------------------------------------
 
@@ -2464,6 +2465,88 @@ FRESULT f_read (
 
 
 
+/*-----------------------------------------------------------------------*/
+/* Load File - Bulk read following the physically contiguous runs       */
+/*-----------------------------------------------------------------------*/
+/* The cluster chain is walked ahead of the data, and each run of
+/  consecutive clusters is read straight to the destination with a single
+/  disk_read_blocks() call, so a defragmented file is loaded in a handful
+/  of large transfers. The trailing partial sector, or a start position
+/  that is not on a cluster boundary, is left to f_read().
+*/
+
+FRESULT f_load_contiguous (
+	FIL *fp, 		/* Pointer to the file object */
+	void *buff,		/* Pointer to data buffer */
+	DWORD btl,		/* Number of bytes to load */
+	DWORD *bl		/* Pointer to number of bytes loaded */
+)
+{
+	FRESULT res;
+	DWORD clst, first, last, sect, nsect, rsect, remain;
+	UINT rcnt;
+	BYTE *rbuff = buff;
+
+
+	*bl = 0;	/* Initialize byte counter */
+
+	res = validate(fp->fs, fp->id);			/* Check validity */
+	if (res != FR_OK) LEAVE_FF(fp->fs, res);
+	if (fp->flag & FA__ERROR)			/* Aborted file? */
+		LEAVE_FF(fp->fs, FR_INT_ERR);
+	if (!(fp->flag & FA_READ)) 			/* Check access mode */
+		LEAVE_FF(fp->fs, FR_DENIED);
+	remain = fp->fsize - fp->fptr;
+	if (btl > remain) btl = remain;			/* Truncate btl by remaining bytes */
+
+	nsect = btl / SS(fp->fs);			/* Whole sectors to load in bulk */
+	if (fp->fptr & (SS(fp->fs) * fp->fs->csize - 1))	/* Not on a cluster boundary? */
+		nsect = 0;
+
+	clst = 0;					/* First cluster of the next run, 0:follow fp->clust */
+	while (nsect) {
+		if (!clst) {
+			clst = fp->fptr ? get_fat(fp->fs, fp->clust) : fp->sclust;
+			if (clst < 2) ABORT(fp->fs, FR_INT_ERR);
+			if (clst == 0xFFFFFFFF) ABORT(fp->fs, FR_DISK_ERR);
+		}
+		first = last = clst;
+		clst = 0;
+		rsect = fp->fs->csize;
+		while (rsect < nsect) {			/* Extend the run while the chain is contiguous */
+			clst = get_fat(fp->fs, last);
+			if (clst < 2) ABORT(fp->fs, FR_INT_ERR);
+			if (clst == 0xFFFFFFFF) ABORT(fp->fs, FR_DISK_ERR);
+			if (clst != last + 1) break;	/* Fragment boundary, clst starts the next run */
+			last = clst;
+			clst = 0;
+			rsect += fp->fs->csize;
+		}
+		if (rsect > nsect) rsect = nsect;
+
+		sect = clust2sect(fp->fs, first);
+		if (!sect) ABORT(fp->fs, FR_INT_ERR);
+		if (disk_read_blocks(fp->fs->drv, rbuff, sect, rsect) != RES_OK)
+			ABORT(fp->fs, FR_DISK_ERR);
+		fp->clust = last;			/* Cluster holding the last sector read */
+
+		rcnt = SS(fp->fs) * rsect;
+		rbuff += rcnt; fp->fptr += rcnt; *bl += rcnt; btl -= rcnt;
+		nsect -= rsect;
+	}
+
+	if (btl) {					/* Leftover data through the sector buffer */
+		res = f_read(fp, rbuff, (UINT)btl, &rcnt);
+		*bl += rcnt;
+		return res;
+	}
+
+	LEAVE_FF(fp->fs, FR_OK);
+}
+
+
+
+
 #if !_FS_READONLY
 /*-----------------------------------------------------------------------*/
 /* Write File                                                            */
@@ -0,0 +1,239 @@
+// Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+//
+// SPDX-License-Identifier: MIT
+
+/*
+ * lib/div.c udiv32(), umod32() and division(), the software division the
+ * cores without UDIV run: checked against the C operators exhaustively
+ * for small operands, for every pair of edge values and for random
+ * pairs of every magnitude, then timed against the division they
+ * replaced and against the divide instruction. "-n" skips the timing.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+extern unsigned int bs_udiv32(unsigned int dividend, unsigned int divisor);
+extern unsigned int bs_umod32(unsigned int dividend, unsigned int divisor);
+extern int bs_division(unsigned int dividend, unsigned int divisor,
+		       unsigned int *quotient, unsigned int *remainder);
+
+/* div_old.c */
+extern unsigned int old_div(unsigned int dividend, unsigned int divisor);
+extern unsigned int native_div(unsigned int dividend, unsigned int divisor);
+extern unsigned int div_by_512(unsigned int dividend);
+extern unsigned int mod_by_512(unsigned int dividend);
+extern unsigned int div_by_1(unsigned int dividend);
+extern unsigned int mod_by_1(unsigned int dividend);
+
+#define SMALL_MAX	4096
+#define RANDOM_PAIRS	20000000
+
+static int failures;
+static unsigned long long checked;
+
+static void check_pair(unsigned int a, unsigned int b)
+{
+	unsigned int q = 0x5a5a5a5a, r = 0xa5a5a5a5;
+	int ret;
+
+	checked++;
+
+	ret = bs_division(a, b, &q, &r);
+	if (ret || q != a / b || r != a % b ||
+	    bs_udiv32(a, b) != a / b || bs_umod32(a, b) != a % b) {
+		if (failures++ < 10)
+			printf("FAIL %u / %u: got %u rem %u, want %u rem %u\n",
+			       a, b, q, r, a / b, a % b);
+	}
+}
+
+static unsigned int rnd_state = 1;
+
+static unsigned int rnd(void)
+{
+	rnd_state ^= rnd_state << 13;
+	rnd_state ^= rnd_state >> 17;
+	rnd_state ^= rnd_state << 5;
+
+	return rnd_state;
+}
+
+/* Uniform in magnitude rather than in value, small numbers are common */
+static unsigned int rnd_magnitude(void)
+{
+	return rnd() >> (rnd() % 32);
+}
+
+static void check_small(void)
+{
+	unsigned int a, b;
+
+	for (a = 0; a < SMALL_MAX; a++)
+		for (b = 1; b < SMALL_MAX; b++)
+			check_pair(a, b);
+}
+
+static void check_edges(void)
+{
+	unsigned int edges[32 * 3 + 2];
+	unsigned int n = 0, i, j, bit;
+
+	for (bit = 0; bit < 32; bit++) {
+		edges[n++] = 1u << bit;
+		edges[n++] = (1u << bit) - 1;
+		edges[n++] = (1u << bit) + 1;
+	}
+	edges[n++] = 0xffffffff;
+	edges[n++] = 0xfffffffe;
+
+	for (i = 0; i < n; i++)
+		for (j = 0; j < n; j++)
+			if (edges[j])
+				check_pair(edges[i], edges[j]);
+}
+
+static void check_random(void)
+{
+	unsigned int i, a, b;
+
+	for (i = 0; i < RANDOM_PAIRS; i++) {
+		a = rnd_magnitude();
+		b = rnd_magnitude();
+		if (b)
+			check_pair(a, b);
+	}
+}
+
+static void check_special(void)
+{
+	unsigned int q = 0x5a5a5a5a, r = 0xa5a5a5a5;
+	unsigned int i, a;
+
+	/* division by zero */
+	if (bs_division(1234, 0, &q, &r) != (int)0xffffffff ||
+	    q != 0x5a5a5a5a || r != 0xa5a5a5a5 ||
+	    bs_udiv32(1234, 0) != 0xffffffff || bs_umod32(1234, 0) != 0xffffffff) {
+		failures++;
+		printf("FAIL division by zero\n");
+	}
+
+	/* either result may be left out */
+	if (bs_division(1000, 7, &q, NULL) || q != 142 ||
+	    bs_division(1000, 7, NULL, &r) || r != 6) {
+		failures++;
+		printf("FAIL division with a NULL result\n");
+	}
+
+	/* the constant power of two shortcuts of div.h */
+	for (i = 0; i < 100000; i++) {
+		a = i < 1000 ? i : rnd();
+		if (div_by_512(a) != a / 512 || mod_by_512(a) != a % 512 ||
+		    div_by_1(a) != a || mod_by_1(a) != 0) {
+			if (failures++ < 10)
+				printf("FAIL constant divisor, %u\n", a);
+		}
+	}
+}
+
+#define BENCH_PAIRS	4096
+#define BENCH_TIME	0.3	/* seconds per measure */
+
+static unsigned int bench_a[BENCH_PAIRS];
+static unsigned int bench_b[BENCH_PAIRS];
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* ns per division */
+static double measure(unsigned int (*fn)(unsigned int, unsigned int))
+{
+	volatile unsigned int sink = 0;
+	unsigned long long calls = 0;
+	double start = now();
+	double elapsed;
+	unsigned int i;
+
+	do {
+		for (i = 0; i < BENCH_PAIRS; i++)
+			sink += fn(bench_a[i], bench_b[i]);
+		calls += BENCH_PAIRS;
+		elapsed = now() - start;
+	} while (elapsed < BENCH_TIME);
+
+	(void)sink;
+
+	return elapsed * 1e9 / calls;
+}
+
+/*
+ * Operands like the bootstrap's: clock rates over baud rates and
+ * dividers, offsets over block and page sizes, and random ones.
+ */
+static void bench(void)
+{
+	static const struct {
+		const char *name;
+		unsigned int dividend_max;
+		unsigned int divisor_min;
+		unsigned int divisor_max;
+	} cases[] = {
+		{ "clock / rate",	  500000000, 100000,	50000000 },
+		{ "offset / 2 KiB page",  0x10000000, 2048,	2048 },
+		{ "offset / 528 B page",  0x01000000, 528,	528 },
+		{ "small quotients",	  100000,    1000,	100000 },
+		{ "random",		  0xffffffff, 1,	0xffffffff },
+	};
+	double t_old, t_new, t_native;
+	unsigned int c, i, span;
+
+	printf("%-22s %9s %9s %9s %7s\n", "case", "old ns", "new ns",
+	       "udiv ns", "ratio");
+	for (c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+		span = cases[c].divisor_max - cases[c].divisor_min + 1;
+		for (i = 0; i < BENCH_PAIRS; i++) {
+			bench_a[i] = rnd() % cases[c].dividend_max;
+			bench_b[i] = cases[c].divisor_min +
+				     (span ? rnd() % span : rnd());
+			if (!bench_b[i])
+				bench_b[i] = 1;
+		}
+
+		t_old = measure(old_div);
+		t_new = measure(bs_udiv32);
+		t_native = measure(native_div);
+		printf("%-22s %9.1f %9.1f %9.1f %6.1fx\n", cases[c].name,
+		       t_old, t_new, t_native, t_old / t_new);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	check_small();
+	check_edges();
+	check_random();
+	check_special();
+
+	if (failures) {
+		printf("div_check: %d failures\n", failures);
+		return 1;
+	}
+	printf("div_check: udiv32, umod32, division ok (%llu pairs: all "
+	       "below %u, edge values, random), division by zero, "
+	       "constant divisors\n", checked, SMALL_MAX);
+
+	if (argc > 1 && !strcmp(argv[1], "-n"))
+		return 0;
+
+	bench();
+
+	return 0;
+}
@@ -0,0 +1,97 @@
+// Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+//
+// SPDX-License-Identifier: MIT
+
+/*
+ * The division lib/div.c had before the restoring loop, built like the
+ * bootstrap code to serve as the timing baseline, and the constant
+ * power of two paths of div() and mod() from div.h.
+ */
+
+#include "div.h"
+
+static int old_division(unsigned int dividend,
+			unsigned int divisor,
+			unsigned int *quotient,
+			unsigned int *remainder)
+{
+	unsigned int shift;
+	unsigned int divisor_shift;
+	unsigned int factor = 0;
+	unsigned char end_flag = 0;
+
+	if (!divisor)
+		return 0xffffffff;
+
+	if (dividend < divisor) {
+		*quotient = 0;
+		*remainder = dividend;
+		return 0;
+	}
+
+	while (dividend >= divisor) {
+		for (shift = 0, divisor_shift = divisor;
+			dividend >= divisor_shift;
+			divisor_shift <<= 1, shift++) {
+			if (dividend - divisor_shift < divisor_shift) {
+				factor += 1 << shift;
+				dividend -= divisor_shift;
+				end_flag = 1;
+				break;
+			}
+		}
+
+		if (end_flag)
+			continue;
+
+		factor += 1 << (shift - 1);
+		dividend -= divisor_shift >> 1;
+	}
+
+	if (quotient)
+		*quotient = factor;
+
+	if (remainder)
+		*remainder = dividend;
+
+	return 0;
+}
+
+unsigned int old_div(unsigned int dividend, unsigned int divisor)
+{
+	unsigned int quotient = 0;
+	unsigned int remainder = 0;
+	int ret;
+
+	ret = old_division(dividend, divisor, &quotient, &remainder);
+	if (ret)
+		return 0xffffffff;
+
+	return quotient;
+}
+
+/* what a core with a divide instruction runs */
+unsigned int native_div(unsigned int dividend, unsigned int divisor)
+{
+	return dividend / divisor;
+}
+
+unsigned int div_by_512(unsigned int dividend)
+{
+	return div(dividend, 512);
+}
+
+unsigned int mod_by_512(unsigned int dividend)
+{
+	return mod(dividend, 512);
+}
+
+unsigned int div_by_1(unsigned int dividend)
+{
+	return div(dividend, 1);
+}
+
+unsigned int mod_by_1(unsigned int dividend)
+{
+	return mod(dividend, 1);
+}
@@ -0,0 +1,13 @@
+/*
+ * Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef __BOARD_H__
+#define __BOARD_H__
+
+/* the PMECC builds its Galois field tables, as on SAMA5D4 */
+#define NO_GALOIS_TABLE_IN_ROM
+
+#endif /* #ifndef __BOARD_H__ */
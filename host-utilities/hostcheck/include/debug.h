@@ -0,0 +1,17 @@
+/*
+ * Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef __DEBUG_H__
+#define __DEBUG_H__
+
+/* the checks print the driver messages, but not the loud ones */
+extern int model_log(const char *fmt_str, ...);
+
+#define dbg_info(fmt_str, arg...)	model_log(fmt_str , ## arg)
+#define dbg_loud(fmt_str, arg...)	({ 0; })
+#define dbg_very_loud(fmt_str, arg...)	({ 0; })
+
+#endif /* #ifndef __DEBUG_H__ */
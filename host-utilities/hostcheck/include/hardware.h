@@ -0,0 +1,27 @@
+/*
+ * Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef __HARDWARE_H__
+#define __HARDWARE_H__
+
+/*
+ * Stands for the tree's hardware.h in the host builds of the drivers:
+ * the peripheral registers are memory blocks of the checks, which model
+ * what the peripheral does on each access.
+ */
+extern unsigned int model_readl(unsigned int addr);
+extern void model_writel(unsigned int value, unsigned int addr);
+
+#define readl(addr)		model_readl(addr)
+#define writel(value, addr)	model_writel((value), (addr))
+
+extern unsigned int model_pmecc_base;
+extern unsigned int model_pmerrloc_base;
+
+#define AT91C_BASE_PMECC	model_pmecc_base
+#define AT91C_BASE_PMERRLOC	model_pmerrloc_base
+
+#endif /* #ifndef __HARDWARE_H__ */
@@ -0,0 +1,417 @@
+// Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+//
+// SPDX-License-Identifier: MIT
+
+/*
+ * lib/lz4.c lz4_decompress(): samples are compressed by the reference
+ * lz4 tool ($LZ4, "lz4" by default) with the options the kernel build
+ * and users pass, and must decode to the original byte for byte. The
+ * decoder must also refuse an output room one byte short, and never
+ * write past its room on truncated or corrupted streams. Then the
+ * decoding speed is timed. "-n" skips the timing; files given on the
+ * command line are added to the samples.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+extern int bs_lz4_decompress(const void *src, unsigned int srclen,
+			     void *dst, unsigned int *dstlen);
+
+#define GUARD		64
+#define CANARY		0xa5
+
+struct sample {
+	const char *name;
+	unsigned char *data;
+	unsigned int size;
+};
+
+static const struct {
+	const char *name;
+	const char *options;
+	int size_append;	/* what the kernel build adds, "lz4 -l" only */
+} variants[] = {
+	{ "frame",			"",			0 },
+	{ "frame -9",			"-9",			0 },
+	{ "frame, 64 KiB blocks",	"-B4",			0 },
+	{ "frame, linked blocks",	"-B4 -BD",		0 },
+	{ "frame, block checksums",	"-B4 -BX",		0 },
+	{ "frame, content size",	"--content-size",	0 },
+	{ "frame, no content checksum",	"--no-frame-crc",	0 },
+	{ "legacy",			"-l",			0 },
+	{ "legacy -9, size appended",	"-l -9",		1 },
+};
+
+static const char *lz4_cmd;
+static char tmpdir[] = "/tmp/lz4_checkXXXXXX";
+static int failures;
+
+static void fail(const char *what, const struct sample *sample,
+		 const char *variant)
+{
+	if (failures++ < 10)
+		printf("FAIL %s: %s, %s\n", what, sample->name, variant);
+}
+
+static unsigned int rnd_state = 1;
+
+static unsigned int rnd(void)
+{
+	rnd_state = rnd_state * 1103515245 + 12345;
+
+	return rnd_state >> 8;
+}
+
+/* Text-like data, with the long and short matches of a real payload */
+static void gen_words(unsigned char *buf, unsigned int size)
+{
+	static const char *const words[] = {
+		"the ", "kernel ", "boot ", "0x20008000 ", "clock ", "dma ",
+		"\n", "\t", "return ", "static ", "int ", "struct ", "{ ",
+	};
+	unsigned int i = 0, n;
+	const char *w;
+
+	while (i < size) {
+		w = words[rnd() % (sizeof(words) / sizeof(words[0]))];
+		for (n = 0; w[n] && i < size; n++)
+			buf[i++] = w[n];
+	}
+}
+
+static void gen_random(unsigned char *buf, unsigned int size)
+{
+	unsigned int i;
+
+	for (i = 0; i < size; i++)
+		buf[i] = rnd();
+}
+
+/* Short repeats: overlapping matches, offsets smaller than the length */
+static void gen_runs(unsigned char *buf, unsigned int size)
+{
+	unsigned int i = 0, period, len, n;
+
+	while (i < size) {
+		period = 1 + rnd() % 7;
+		len = 4 + rnd() % 300;
+		for (n = 0; n < len && i < size; n++)
+			buf[i++] = (n % period) * 37 + period;
+		if (i < size)
+			buf[i++] = rnd();
+	}
+}
+
+static void gen_zero(unsigned char *buf, unsigned int size)
+{
+	memset(buf, 0, size);
+}
+
+/* Mostly text, with incompressible stretches stored as raw blocks */
+static void gen_mixed(unsigned char *buf, unsigned int size)
+{
+	unsigned int i, len;
+
+	for (i = 0; i < size; i += len) {
+		len = 4096 + rnd() % 65536;
+		if (len > size - i)
+			len = size - i;
+		if (rnd() % 4)
+			gen_words(buf + i, len);
+		else
+			gen_random(buf + i, len);
+	}
+}
+
+static void make_sample(struct sample *sample, const char *name,
+			unsigned int size,
+			void (*gen)(unsigned char *, unsigned int))
+{
+	sample->name = name;
+	sample->size = size;
+	sample->data = malloc(size ? size : 1);
+	if (!sample->data) {
+		printf("lz4_check: out of memory\n");
+		exit(1);
+	}
+	gen(sample->data, size);
+}
+
+static int read_file(const char *path, unsigned char **data,
+		     unsigned int *size)
+{
+	FILE *f = fopen(path, "rb");
+	long len;
+
+	if (!f)
+		return -1;
+
+	fseek(f, 0, SEEK_END);
+	len = ftell(f);
+	fseek(f, 0, SEEK_SET);
+
+	*data = malloc(len ? len : 1);
+	if (!*data || fread(*data, 1, len, f) != (size_t)len) {
+		fclose(f);
+		return -1;
+	}
+	*size = len;
+	fclose(f);
+
+	return 0;
+}
+
+static int write_file(const char *path, const unsigned char *data,
+		      unsigned int size)
+{
+	FILE *f = fopen(path, "wb");
+	int ret = 0;
+
+	if (!f)
+		return -1;
+	if (fwrite(data, 1, size, f) != size)
+		ret = -1;
+	if (fclose(f))
+		ret = -1;
+
+	return ret;
+}
+
+/* Compress @sample with the reference tool, the result is malloc'ed */
+static int compress(const struct sample *sample, unsigned int variant,
+		    unsigned char **out, unsigned int *outlen)
+{
+	char in_path[64], out_path[64], cmd[256];
+	unsigned int size = sample->size;
+
+	snprintf(in_path, sizeof(in_path), "%s/in", tmpdir);
+	snprintf(out_path, sizeof(out_path), "%s/out", tmpdir);
+
+	if (write_file(in_path, sample->data, size))
+		return -1;
+
+	snprintf(cmd, sizeof(cmd), "%s -q -f %s %s %s", lz4_cmd,
+		 variants[variant].options, in_path, out_path);
+	if (system(cmd))
+		return -1;
+
+	if (read_file(out_path, out, outlen))
+		return -1;
+
+	if (variants[variant].size_append) {
+		*out = realloc(*out, *outlen + 4);
+		if (!*out)
+			return -1;
+		(*out)[(*outlen)++] = size;
+		(*out)[(*outlen)++] = size >> 8;
+		(*out)[(*outlen)++] = size >> 16;
+		(*out)[(*outlen)++] = size >> 24;
+	}
+
+	return 0;
+}
+
+static int canaries_intact(const unsigned char *buf, unsigned int room)
+{
+	unsigned int i;
+
+	for (i = 0; i < GUARD; i++)
+		if (buf[i] != CANARY || buf[GUARD + room + i] != CANARY)
+			return 0;
+
+	return 1;
+}
+
+/* Decode to a room of @room bytes between canaries */
+static int decode(const unsigned char *src, unsigned int srclen,
+		  unsigned char *buf, unsigned int room, unsigned int *outlen)
+{
+	int ret;
+
+	memset(buf, CANARY, GUARD + room + GUARD);
+	*outlen = room;
+	ret = bs_lz4_decompress(src, srclen, buf + GUARD, outlen);
+
+	if (!canaries_intact(buf, room))
+		return -2;
+
+	return ret;
+}
+
+static void check_sample(const struct sample *sample, unsigned int variant)
+{
+	const char *name = variants[variant].name;
+	unsigned char *comp, *buf, *bad;
+	unsigned int complen, outlen, i, pos;
+	int ret;
+
+	if (compress(sample, variant, &comp, &complen)) {
+		fail("lz4 tool", sample, name);
+		return;
+	}
+
+	buf = malloc(GUARD + sample->size + GUARD);
+	bad = malloc(complen);
+	if (!buf || !bad) {
+		printf("lz4_check: out of memory\n");
+		exit(1);
+	}
+
+	/* exact room */
+	ret = decode(comp, complen, buf, sample->size, &outlen);
+	if (ret || outlen != sample->size ||
+	    memcmp(buf + GUARD, sample->data, sample->size))
+		fail(ret == -2 ? "overrun" : "round trip", sample, name);
+
+	/* one byte short */
+	if (sample->size) {
+		ret = decode(comp, complen, buf, sample->size - 1, &outlen);
+		if (ret != -1)
+			fail(ret == -2 ? "overrun, short room" :
+			     "accepted a short room", sample, name);
+	}
+
+	/* truncated streams */
+	for (i = 0; i < 64 && i < complen; i++) {
+		pos = i < 16 ? i : rnd() % complen;
+		if (decode(comp, pos, buf, sample->size, &outlen) == -2)
+			fail("overrun, truncated stream", sample, name);
+	}
+
+	/* corrupted streams: any result but an overrun or a crash */
+	for (i = 0; i < 256 && complen; i++) {
+		memcpy(bad, comp, complen);
+		pos = rnd() % complen;
+		bad[pos] ^= 1 << (rnd() % 8);
+		if (i & 1)
+			bad[rnd() % complen] = rnd();
+		if (decode(bad, complen, buf, sample->size, &outlen) == -2)
+			fail("overrun, corrupted stream", sample, name);
+	}
+
+	free(bad);
+	free(buf);
+	free(comp);
+}
+
+#define BENCH_TIME	0.3	/* seconds per measure */
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Output MB/s for the decoding of @sample */
+static void bench(const struct sample *sample, unsigned int variant)
+{
+	unsigned char *comp, *buf;
+	unsigned int complen, outlen, rounds = 0;
+	double start, elapsed;
+
+	if (compress(sample, variant, &comp, &complen))
+		return;
+
+	buf = malloc(sample->size);
+	if (!buf) {
+		printf("lz4_check: out of memory\n");
+		exit(1);
+	}
+
+	start = now();
+	do {
+		outlen = sample->size;
+		bs_lz4_decompress(comp, complen, buf, &outlen);
+		rounds++;
+		elapsed = now() - start;
+	} while (elapsed < BENCH_TIME);
+
+	printf("%-12s %-28s %5.1f%% %8.0f\n", sample->name,
+	       variants[variant].name, 100.0 * complen / sample->size,
+	       (double)rounds * sample->size / elapsed / 1e6);
+
+	free(buf);
+	free(comp);
+}
+
+int main(int argc, char **argv)
+{
+	struct sample samples[16];
+	unsigned int nr_samples = 0, nr_generated, i, v;
+	int arg = 1, timing = 1;
+	char cmd[256];
+
+	if (arg < argc && !strcmp(argv[arg], "-n")) {
+		timing = 0;
+		arg++;
+	}
+
+	lz4_cmd = getenv("LZ4");
+	if (!lz4_cmd)
+		lz4_cmd = "lz4";
+
+	snprintf(cmd, sizeof(cmd), "%s -V >/dev/null 2>&1", lz4_cmd);
+	if (system(cmd)) {
+		printf("lz4_check: SKIPPED, no \"%s\" tool to compress the samples\n",
+		       lz4_cmd);
+		return 0;
+	}
+
+	if (!mkdtemp(tmpdir)) {
+		printf("lz4_check: cannot create %s\n", tmpdir);
+		return 1;
+	}
+
+	make_sample(&samples[nr_samples++], "empty", 0, gen_zero);
+	make_sample(&samples[nr_samples++], "tiny", 13, gen_words);
+	make_sample(&samples[nr_samples++], "zeroes", 200000, gen_zero);
+	make_sample(&samples[nr_samples++], "runs", 300000, gen_runs);
+	make_sample(&samples[nr_samples++], "random", 150000, gen_random);
+	make_sample(&samples[nr_samples++], "text", 1000000, gen_words);
+	make_sample(&samples[nr_samples++], "mixed", 4000000, gen_mixed);
+	nr_generated = nr_samples;
+
+	for (; arg < argc && nr_samples < 16; arg++) {
+		samples[nr_samples].name = argv[arg];
+		if (read_file(argv[arg], &samples[nr_samples].data,
+			      &samples[nr_samples].size)) {
+			printf("lz4_check: cannot read %s\n", argv[arg]);
+			return 1;
+		}
+		nr_samples++;
+	}
+
+	for (i = 0; i < nr_samples; i++)
+		for (v = 0; v < sizeof(variants) / sizeof(variants[0]); v++)
+			check_sample(&samples[i], v);
+
+	if (failures) {
+		printf("lz4_check: %d failures\n", failures);
+	} else {
+		printf("lz4_check: %u samples x %u formats decoded ok, short "
+		       "rooms refused, no overrun on damaged streams\n",
+		       nr_samples, (unsigned int)(sizeof(variants) /
+						  sizeof(variants[0])));
+
+		if (timing) {
+			printf("%-12s %-28s %6s %8s\n", "sample", "format",
+			       "ratio", "MB/s out");
+			for (i = nr_generated - 2; i < nr_samples; i++) {
+				bench(&samples[i], 0);
+				bench(&samples[i], 7);
+			}
+		}
+	}
+
+	snprintf(cmd, sizeof(cmd), "rm -rf %s", tmpdir);
+	system(cmd);
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,636 @@
+// Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+//
+// SPDX-License-Identifier: MIT
+
+/*
+ * driver/pmecc.c correction, the software half of the PMECC: pages are
+ * BCH encoded, random bit errors are injected in every sector, and
+ * pmecc_process() must give the original page back. The hardware half
+ * is modelled:
+ * - the PMECC remainder registers hold, for each sector, the remainders
+ *   of the read codeword by the minimal polynomials m1, m3, ... m(2t-1);
+ * - the PMERRLOC root finder searches the roots of the error locator
+ *   written to the SIGMA registers and reports the error positions.
+ *
+ * Bit p of a sector, counting the data bytes then the ECC bytes from
+ * bit 0 of the first byte, is the coefficient of x^(n - 1 - p) of the
+ * codeword of n bits. The driver only sees the remainders and the
+ * positions, so this order is the model's own choice.
+ *
+ * Then the correction is timed per sector for 1, t/2 and t errors,
+ * without the time the model spends in the root finder. "-n" skips the
+ * timing. To compare the decoder with another version of it:
+ *
+ *	make clean run-pmecc_check PMECC_C=/path/to/pmecc.c
+ */
+
+#define _GNU_SOURCE
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#ifdef __x86_64__
+#include <x86intrin.h>
+#endif
+
+#include "../../include/nand.h"
+#include "../../include/arch/at91_nand_ecc.h"
+
+extern int bs_init_pmecc(struct nand_info *nand);
+extern int bs_pmecc_process(struct nand_info *nand, unsigned char *buffer);
+extern int bs_get_pmecc_bytes(unsigned int sector_size, unsigned int ecc_bits);
+
+/* where pmecc.c builds its tables without a ROM copy */
+#define GF_TABLE_ADDR		0x21000000
+#define GF_TABLE_SIZE		0x10000
+
+#define MAX_SECTORS		4
+#define MAX_SECTOR_SIZE		1024
+#define MAX_TT			24
+#define MAX_ECC_BYTES_SECTOR	42
+#define MAX_CODE_BITS		(8 * MAX_SECTOR_SIZE + 14 * MAX_TT)
+
+/* generator polynomials, up to degree 14 * 24 */
+#define POLY_WORDS		6
+
+#define CHECK_PAGES		300
+#define BENCH_PAGES		50
+
+unsigned int bs_model_pmecc_base;
+unsigned int bs_model_pmerrloc_base;
+
+static int verbose;
+static int failures;
+
+static void fail(const char *fmt, ...)
+{
+	va_list ap;
+
+	if (failures++ >= 10)
+		return;
+
+	printf("FAIL ");
+	va_start(ap, fmt);
+	vprintf(fmt, ap);
+	va_end(ap);
+	printf("\n");
+}
+
+int bs_model_log(const char *fmt, ...)
+{
+	va_list ap;
+
+	if (!verbose)
+		return 0;
+
+	va_start(ap, fmt);
+	vprintf(fmt, ap);
+	va_end(ap);
+
+	return 0;
+}
+
+static unsigned int rnd_state = 1;
+
+static unsigned int rnd(void)
+{
+	rnd_state ^= rnd_state << 13;
+	rnd_state ^= rnd_state >> 17;
+	rnd_state ^= rnd_state << 5;
+
+	return rnd_state;
+}
+
+static unsigned long long timestamp(void)
+{
+#ifdef __x86_64__
+	return __rdtsc();
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+#ifdef __x86_64__
+#define TIME_UNIT	"TSC cycles"
+#else
+#define TIME_UNIT	"ns"
+#endif
+
+/*
+ * GF(2^mm), built independently of pmecc.c from the primitive
+ * polynomials of the PMECC: x^13 + x^4 + x^3 + x + 1 and
+ * x^14 + x^10 + x^6 + x + 1.
+ */
+static int mm, nn;
+static int alpha_to[1 << 14];
+static int index_of[1 << 14];
+
+static void gf_init(int m)
+{
+	unsigned int poly = (m == 13) ? 0x201b : 0x4443;
+	unsigned int value = 1;
+	int i;
+
+	mm = m;
+	nn = (1 << m) - 1;
+
+	for (i = 0; i < nn; i++) {
+		alpha_to[i] = value;
+		index_of[value] = i;
+		value <<= 1;
+		if (value & (1 << m))
+			value ^= poly;
+	}
+	alpha_to[nn] = 1;
+	index_of[0] = -1;
+}
+
+static int gf_mul(int a, int b)
+{
+	if (!a || !b)
+		return 0;
+
+	return alpha_to[(index_of[a] + index_of[b]) % nn];
+}
+
+/* Minimal polynomial of alpha^i over GF(2), bit k for x^k */
+static unsigned int min_poly(int i)
+{
+	int coef[16] = { 1 };
+	unsigned int poly = 0;
+	int deg = 0;
+	int j = i, k;
+
+	/* product of the (x + alpha^j) for the conjugates of alpha^i */
+	do {
+		coef[deg + 1] = 0;
+		for (k = deg + 1; k > 0; k--)
+			coef[k] = coef[k - 1] ^ gf_mul(coef[k], alpha_to[j]);
+		coef[0] = gf_mul(coef[0], alpha_to[j]);
+		deg++;
+		j = (2 * j) % nn;
+	} while (j != i);
+
+	for (k = 0; k <= deg; k++) {
+		if (coef[k] & ~1)
+			fail("minimal polynomial of alpha^%d not binary", i);
+		poly |= (coef[k] & 1) << k;
+	}
+
+	return poly;
+}
+
+static int poly_degree(unsigned int poly)
+{
+	return 31 - __builtin_clz(poly);
+}
+
+/* The code in use: t, sector size, generator and remainder divisors */
+static struct {
+	int tt;
+	unsigned int sector_size;
+	unsigned int sectors;
+	unsigned int ecc_bytes;		/* per sector */
+	unsigned int data_bits;
+	unsigned int code_bits;		/* n */
+	unsigned int rem_poly[MAX_TT];	/* m(2i+1) */
+	uint64_t gen[POLY_WORDS];	/* without its x^r term */
+	int gen_degree;			/* r */
+} code;
+
+static int poly_bit(const uint64_t *poly, int k)
+{
+	return (poly[k / 64] >> (k % 64)) & 1;
+}
+
+static void code_init(unsigned int sector_size, int tt)
+{
+	uint64_t gen[POLY_WORDS + 1] = { 1 };
+	uint64_t prod[POLY_WORDS + 1];
+	unsigned int used[MAX_TT];
+	unsigned int nr_used = 0, poly, u;
+	int deg = 0, i, k, w, d;
+
+	gf_init(sector_size == 512 ? 13 : 14);
+
+	code.tt = tt;
+	code.sector_size = sector_size;
+	code.data_bits = 8 * sector_size;
+
+	/* g = lcm(m1, m3, ... m(2t-1)) */
+	for (i = 0; i < tt; i++) {
+		poly = min_poly(2 * i + 1);
+		code.rem_poly[i] = poly;
+
+		for (u = 0; u < nr_used; u++)
+			if (used[u] == poly)
+				break;
+		if (u < nr_used)
+			continue;
+		used[nr_used++] = poly;
+
+		d = poly_degree(poly);
+		memset(prod, 0, sizeof(prod));
+		for (k = 0; k <= d; k++) {
+			if (!(poly & (1 << k)))
+				continue;
+			for (w = POLY_WORDS; w >= 0; w--) {
+				prod[w] ^= gen[w] << (k % 64);
+				if (k % 64 && w)
+					prod[w] ^= gen[w - 1] >> (64 - k % 64);
+			}
+		}
+		memcpy(gen, prod, sizeof(gen));
+		deg += d;
+	}
+
+	code.gen_degree = deg;
+	memcpy(code.gen, gen, sizeof(code.gen));
+	code.gen[deg / 64] &= ~(1ULL << (deg % 64));
+
+	code.code_bits = code.data_bits + deg;
+	code.ecc_bytes = (deg + 7) / 8;
+
+	if (deg != mm * tt)
+		fail("%u/%d: generator of degree %d, not %d", sector_size, tt,
+		     deg, mm * tt);
+}
+
+static int get_bit(const unsigned char *data, const unsigned char *ecc,
+		   unsigned int p)
+{
+	if (p < code.data_bits)
+		return (data[p / 8] >> (p % 8)) & 1;
+
+	p -= code.data_bits;
+
+	return (ecc[p / 8] >> (p % 8)) & 1;
+}
+
+static void flip_bit(unsigned char *data, unsigned char *ecc, unsigned int p)
+{
+	if (p < code.data_bits) {
+		data[p / 8] ^= 1 << (p % 8);
+	} else {
+		p -= code.data_bits;
+		ecc[p / 8] ^= 1 << (p % 8);
+	}
+}
+
+/* Parity: data(x) * x^r mod g(x), systematic encoding */
+static void encode_sector(const unsigned char *data, unsigned char *ecc)
+{
+	uint64_t reg[POLY_WORDS] = { 0 };
+	int r = code.gen_degree;
+	unsigned int p;
+	int fb, w, q;
+
+	for (p = 0; p < code.data_bits; p++) {
+		fb = ((data[p / 8] >> (p % 8)) & 1) ^ poly_bit(reg, r - 1);
+
+		for (w = POLY_WORDS - 1; w > 0; w--)
+			reg[w] = (reg[w] << 1) | (reg[w - 1] >> 63);
+		reg[0] <<= 1;
+		reg[r / 64] &= ~(~0ULL << (r % 64));
+		for (w = r / 64 + 1; w < POLY_WORDS; w++)
+			reg[w] = 0;
+
+		if (fb)
+			for (w = 0; w < POLY_WORDS; w++)
+				reg[w] ^= code.gen[w];
+	}
+
+	/* x^k goes to code bit data_bits + r - 1 - k */
+	memset(ecc, 0, code.ecc_bytes);
+	for (q = 0; q < r; q++)
+		if (poly_bit(reg, r - 1 - q))
+			ecc[q / 8] |= 1 << (q % 8);
+}
+
+static unsigned char *pmecc_regs;
+static unsigned char *pmerrloc_regs;
+static unsigned long long model_time;
+
+static unsigned int *reg32(unsigned char *block, unsigned int offset)
+{
+	return (unsigned int *)(block + offset);
+}
+
+/* What the PMECC leaves after reading a page: remainders and ISR */
+static void model_read_page(unsigned char *page, unsigned int eccpos)
+{
+	unsigned char *data, *ecc;
+	unsigned short *rem;
+	unsigned int s, p, i, isr = 0, bit, reg;
+	unsigned int regs[MAX_TT];
+
+	for (s = 0; s < code.sectors; s++) {
+		data = page + s * code.sector_size;
+		ecc = page + code.sectors * code.sector_size + eccpos
+		      + s * code.ecc_bytes;
+
+		memset(regs, 0, sizeof(regs));
+		for (p = 0; p < code.code_bits; p++) {
+			bit = get_bit(data, ecc, p);
+			for (i = 0; i < (unsigned int)code.tt; i++) {
+				reg = (regs[i] << 1) | bit;
+				if (reg & (1 << mm))
+					reg ^= code.rem_poly[i];
+				regs[i] = reg;
+			}
+		}
+
+		rem = (unsigned short *)(pmecc_regs + PMECC_REM + s * 0x40);
+		for (i = 0; i < (unsigned int)code.tt; i++) {
+			rem[i] = regs[i];
+			if (regs[i])
+				isr |= 1 << s;
+		}
+	}
+
+	*reg32(pmecc_regs, PMECC_SR) = 0;
+	*reg32(pmecc_regs, PMECC_ISR) = isr;
+}
+
+/* PMERRLOC: roots of sigma among alpha^-e, e < n, as positions n - e */
+static void model_error_location(unsigned int len)
+{
+	unsigned long long start = timestamp();
+	unsigned int degree = (*reg32(pmerrloc_regs, PMERRLOC_ELCFG) >> 16) & 0x1f;
+	unsigned int *sigma = reg32(pmerrloc_regs, PMERRLOC_SIGMA0);
+	unsigned int *el = reg32(pmerrloc_regs, PMERRLOC_EL0);
+	int exp[32];
+	unsigned int k, e, roots = 0;
+	int val;
+
+	if (len != code.code_bits)
+		fail("ELEN %u, the code has %u bits", len, code.code_bits);
+
+	for (k = 0; k <= degree; k++)
+		exp[k] = sigma[k] ? index_of[sigma[k]] : -1;
+
+	for (e = 0; e < len; e++) {
+		val = 0;
+		for (k = 0; k <= degree; k++) {
+			if (exp[k] < 0)
+				continue;
+			val ^= alpha_to[exp[k]];
+			/* next e: one more alpha^-k */
+			exp[k] -= k;
+			if (exp[k] < 0)
+				exp[k] += nn;
+		}
+		if (!val && roots < 32)
+			el[roots++] = len - e;
+	}
+
+	*reg32(pmerrloc_regs, PMERRLOC_ELISR) = PMERRLOC_ELISR_DONE
+		| ((roots << 8) & PMERRLOC_ELISR_ERR_CNT);
+
+	model_time += timestamp() - start;
+}
+
+unsigned int bs_model_readl(unsigned int addr)
+{
+	return *(volatile unsigned int *)(uintptr_t)addr;
+}
+
+void bs_model_writel(unsigned int value, unsigned int addr)
+{
+	*(volatile unsigned int *)(uintptr_t)addr = value;
+
+	if (addr == bs_model_pmerrloc_base + PMERRLOC_ELEN)
+		model_error_location(value);
+}
+
+/* Memory the driver may address with 32-bit integers */
+static void *map_low(void *addr, size_t size)
+{
+	int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+	void *p;
+
+	if (addr)
+		flags |= MAP_FIXED_NOREPLACE;
+	else
+		flags |= MAP_32BIT;
+
+	p = mmap(addr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+	if (p == MAP_FAILED || (addr && p != addr)) {
+		printf("pmecc_check: cannot map memory below 4 GB\n");
+		exit(1);
+	}
+
+	return p;
+}
+
+static struct nand_ooblayout layout;
+static struct nand_info nand;
+static unsigned char *page, *orig;
+
+static int setup(unsigned int sector_size, int tt)
+{
+	unsigned int i, eccbytes;
+	short *gf_index = (short *)GF_TABLE_ADDR;
+	short *gf_alpha;
+
+	code_init(sector_size, tt);
+	code.sectors = MAX_SECTORS;
+
+	if ((int)code.ecc_bytes != bs_get_pmecc_bytes(sector_size, tt))
+		fail("%u/%d: %u ECC bytes, get_pmecc_bytes() says %d",
+		     sector_size, tt, code.ecc_bytes,
+		     bs_get_pmecc_bytes(sector_size, tt));
+
+	eccbytes = code.sectors * code.ecc_bytes;
+	layout.eccbytes = eccbytes;
+	for (i = 0; i < eccbytes; i++)
+		layout.eccpos[i] = 2 + i;
+
+	memset(&nand, 0, sizeof(nand));
+	nand.pagesize = code.sectors * sector_size;
+	nand.oobsize = 2 + eccbytes;
+	nand.ecclayout = &layout;
+	nand.ecc_sector_size = sector_size;
+	nand.ecc_err_bits = tt;
+
+	if (bs_init_pmecc(&nand))
+		return -1;
+
+	/* the field pmecc.c built must be the model's */
+	gf_alpha = gf_index + (sector_size == 512 ? 0x2000 : 0x4000);
+	for (i = 0; i < (unsigned int)nn; i++)
+		if (gf_alpha[i] != alpha_to[i] ||
+		    gf_index[alpha_to[i]] != (short)i) {
+			fail("%u/%d: pmecc.c field differs at alpha^%u",
+			     sector_size, tt, i);
+			break;
+		}
+
+	return 0;
+}
+
+static void fill_page(void)
+{
+	unsigned int s, i;
+
+	for (i = 0; i < nand.pagesize + nand.oobsize; i++)
+		page[i] = rnd();
+	page[nand.pagesize] = 0xff;
+	page[nand.pagesize + 1] = 0xff;
+
+	for (s = 0; s < code.sectors; s++)
+		encode_sector(page + s * code.sector_size,
+			      page + nand.pagesize + 2 + s * code.ecc_bytes);
+
+	memcpy(orig, page, nand.pagesize + nand.oobsize);
+}
+
+/* @errors distinct random bit errors in sector @s */
+static void inject(unsigned int s, unsigned int errors)
+{
+	unsigned int pos[MAX_TT];
+	unsigned int i, j, p;
+
+	for (i = 0; i < errors; i++) {
+		do {
+			p = rnd() % code.code_bits;
+			for (j = 0; j < i; j++)
+				if (pos[j] == p)
+					break;
+		} while (j < i);
+		pos[i] = p;
+
+		flip_bit(page + s * code.sector_size,
+			 page + nand.pagesize + 2 + s * code.ecc_bytes, p);
+	}
+}
+
+static unsigned int pages_checked, errors_corrected;
+
+static void check_correction(void)
+{
+	unsigned int n, s, errors;
+	int ret;
+
+	for (n = 0; n < CHECK_PAGES; n++) {
+		fill_page();
+
+		for (s = 0; s < code.sectors; s++) {
+			/* clean sectors too, and the worst case often */
+			errors = rnd() % (code.tt + 2);
+			if (errors > (unsigned int)code.tt)
+				errors = code.tt;
+			inject(s, errors);
+			errors_corrected += errors;
+		}
+
+		model_read_page(page, 2);
+		ret = bs_pmecc_process(&nand, page);
+		pages_checked++;
+
+		if (ret || memcmp(page, orig, nand.pagesize + nand.oobsize)) {
+			fail("%u/%d: page %u %s", code.sector_size, code.tt,
+			     n, ret ? "reported uncorrectable" :
+			     "not corrected");
+			return;
+		}
+	}
+}
+
+/* Time per corrected sector with @errors errors in every sector */
+static double bench(unsigned int errors)
+{
+	unsigned long long total = 0, start;
+	unsigned int n, s;
+
+	for (n = 0; n < BENCH_PAGES; n++) {
+		fill_page();
+		for (s = 0; s < code.sectors; s++)
+			inject(s, errors);
+		model_read_page(page, 2);
+
+		model_time = 0;
+		start = timestamp();
+		if (bs_pmecc_process(&nand, page))
+			fail("%u/%d: bench page %u uncorrectable",
+			     code.sector_size, code.tt, n);
+		total += timestamp() - start - model_time;
+	}
+
+	return (double)total / (BENCH_PAGES * code.sectors);
+}
+
+int main(int argc, char **argv)
+{
+	static const unsigned int sector_sizes[] = { 512, 1024 };
+	static const int strengths[] = { 2, 4, 8, 12, 24 };
+	unsigned int z, t;
+	int timing = 1;
+	int arg;
+
+	for (arg = 1; arg < argc; arg++) {
+		if (!strcmp(argv[arg], "-n"))
+			timing = 0;
+		else if (!strcmp(argv[arg], "-v"))
+			verbose = 1;
+	}
+
+	map_low((void *)GF_TABLE_ADDR, GF_TABLE_SIZE);
+	pmecc_regs = map_low(NULL, 0x1000);
+	pmerrloc_regs = map_low(NULL, 0x1000);
+	bs_model_pmecc_base = (unsigned int)(uintptr_t)pmecc_regs;
+	bs_model_pmerrloc_base = (unsigned int)(uintptr_t)pmerrloc_regs;
+	page = map_low(NULL, 2 * (MAX_SECTORS * MAX_SECTOR_SIZE + 512));
+	orig = page + MAX_SECTORS * MAX_SECTOR_SIZE + 512;
+
+	for (z = 0; z < 2; z++)
+		for (t = 0; t < sizeof(strengths) / sizeof(strengths[0]); t++) {
+			if (setup(sector_sizes[z], strengths[t])) {
+				fail("%u/%d: init_pmecc() failed",
+				     sector_sizes[z], strengths[t]);
+				continue;
+			}
+			check_correction();
+		}
+
+	/* the driver has no 32-bit mode: TT_MAX is 25 */
+	memset(&nand, 0, sizeof(nand));
+	nand.pagesize = 2048;
+	nand.ecclayout = &layout;
+	nand.ecc_sector_size = 512;
+	nand.ecc_err_bits = 32;
+	if (!bs_init_pmecc(&nand))
+		fail("init_pmecc() accepted 32-bit correction");
+
+	if (failures) {
+		printf("pmecc_check: %d failures\n", failures);
+		return 1;
+	}
+	printf("pmecc_check: %u pages of %u sectors corrected, %u bit errors "
+	       "(0 to t per sector, t = 2 to 24, 512 and 1024 byte sectors)\n",
+	       pages_checked, MAX_SECTORS, errors_corrected);
+
+	if (!timing)
+		return 0;
+
+	printf("%-8s %4s %14s %14s %14s\n", "sector", "t",
+	       "1 error", "t/2 errors", "t errors");
+	for (z = 0; z < 2; z++)
+		for (t = 0; t < sizeof(strengths) / sizeof(strengths[0]); t++) {
+			if (setup(sector_sizes[z], strengths[t]))
+				continue;
+			printf("%-8u %4d %14.0f %14.0f %14.0f\n",
+			       sector_sizes[z], strengths[t], bench(1),
+			       bench(strengths[t] / 2), bench(strengths[t]));
+		}
+	printf("(%s per corrected sector, root search excluded)\n", TIME_UNIT);
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,262 @@
+// Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+//
+// SPDX-License-Identifier: MIT
+
+/*
+ * lib/string.c memcpy(), memset() and memmove(): checked byte for byte
+ * against the C library for every source and destination alignment and
+ * overlap distance, then timed against the byte loops they replaced.
+ * "-n" skips the timing.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+extern void *bs_memcpy(void *dst, const void *src, int cnt);
+extern void *bs_memset(void *dst, int val, int cnt);
+extern void *bs_memmove(void *dst, const void *src, unsigned int cnt);
+
+/* string_old.c */
+extern void *old_memcpy(void *dst, const void *src, int cnt);
+extern void *old_memset(void *dst, int val, int cnt);
+extern void *old_memmove(void *dst, const void *src, unsigned int cnt);
+
+#define MAX_LEN		300
+#define MAX_ALIGN	8
+#define GUARD		32
+#define BUF_SIZE	(GUARD + MAX_ALIGN + MAX_LEN + MAX_ALIGN + GUARD)
+
+#define CANARY		0xa5
+
+/* memmove() distances, both ways */
+#define MAX_DELTA	(2 * MAX_ALIGN + 8)
+
+static unsigned char src_buf[BUF_SIZE];
+static unsigned char dst_buf[BUF_SIZE];
+static unsigned char ref_buf[BUF_SIZE];
+
+static int failures;
+
+static void fail(const char *what, unsigned int dalign, unsigned int salign,
+		 unsigned int len)
+{
+	if (failures++ < 10)
+		printf("FAIL %s: dst +%u, src +%u, len %u\n",
+		       what, dalign, salign, len);
+}
+
+static void fill_pattern(unsigned char *buf, unsigned int size,
+			 unsigned int seed)
+{
+	unsigned int i;
+
+	for (i = 0; i < size; i++)
+		buf[i] = (unsigned char)(i * 7 + seed * 13 + 1);
+}
+
+static void check_memcpy(void)
+{
+	unsigned int dalign, salign, len;
+	unsigned char *dst, *src;
+	void *ret;
+
+	fill_pattern(src_buf, BUF_SIZE, 0);
+
+	for (dalign = 0; dalign < MAX_ALIGN; dalign++)
+		for (salign = 0; salign < MAX_ALIGN; salign++)
+			for (len = 0; len <= MAX_LEN; len++) {
+				dst = dst_buf + GUARD + dalign;
+				src = src_buf + GUARD + salign;
+
+				memset(dst_buf, CANARY, BUF_SIZE);
+				memset(ref_buf, CANARY, BUF_SIZE);
+				memcpy(ref_buf + GUARD + dalign, src, len);
+
+				ret = bs_memcpy(dst, src, len);
+				if (ret != dst ||
+				    memcmp(dst_buf, ref_buf, BUF_SIZE))
+					fail("memcpy", dalign, salign, len);
+			}
+}
+
+static void check_memset(void)
+{
+	static const int values[] = { 0x00, 0xff, 0x5a, 0x1c3 };
+	unsigned int dalign, len, v;
+	unsigned char *dst;
+	void *ret;
+
+	for (v = 0; v < sizeof(values) / sizeof(values[0]); v++)
+		for (dalign = 0; dalign < MAX_ALIGN; dalign++)
+			for (len = 0; len <= MAX_LEN; len++) {
+				dst = dst_buf + GUARD + dalign;
+
+				memset(dst_buf, CANARY, BUF_SIZE);
+				memset(ref_buf, CANARY, BUF_SIZE);
+				memset(ref_buf + GUARD + dalign,
+				       (unsigned char)values[v], len);
+
+				ret = bs_memset(dst, values[v], len);
+				if (ret != dst ||
+				    memcmp(dst_buf, ref_buf, BUF_SIZE))
+					fail("memset", dalign, v, len);
+			}
+}
+
+/* Source and destination in the same buffer, at every distance */
+static void check_memmove(void)
+{
+	unsigned int salign, len;
+	int delta;
+	unsigned char *dst, *src;
+	void *ret;
+
+	for (salign = 0; salign < MAX_ALIGN; salign++)
+		for (delta = -MAX_DELTA; delta <= MAX_DELTA; delta++)
+			for (len = 0; len <= MAX_LEN - MAX_DELTA; len++) {
+				src = dst_buf + GUARD + MAX_DELTA + salign;
+				dst = src + delta;
+
+				fill_pattern(dst_buf, BUF_SIZE, len);
+				memcpy(ref_buf, dst_buf, BUF_SIZE);
+				memmove(ref_buf + (dst - dst_buf),
+					ref_buf + (src - dst_buf), len);
+
+				ret = bs_memmove(dst, src, len);
+				if (ret != dst ||
+				    memcmp(dst_buf, ref_buf, BUF_SIZE))
+					fail("memmove", salign + delta, salign,
+					     len);
+			}
+}
+
+#define BENCH_SIZE	(256 * 1024)
+#define BENCH_TIME	0.2	/* seconds per measure */
+
+static unsigned char *bench_src;
+static unsigned char *bench_dst;
+
+enum { OP_MEMCPY, OP_MEMSET, OP_MEMMOVE };
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void run_op(int op, int old, unsigned int dalign, unsigned int salign)
+{
+	unsigned char *d = bench_dst + dalign;
+	unsigned char *s = bench_src + salign;
+
+	switch (op) {
+	case OP_MEMCPY:
+		if (old)
+			old_memcpy(d, s, BENCH_SIZE);
+		else
+			bs_memcpy(d, s, BENCH_SIZE);
+		break;
+	case OP_MEMSET:
+		if (old)
+			old_memset(d, 0x5a, BENCH_SIZE);
+		else
+			bs_memset(d, 0x5a, BENCH_SIZE);
+		break;
+	case OP_MEMMOVE:
+		/* overlapping, backward */
+		d = bench_src + 64 + dalign;
+		if (old)
+			old_memmove(d, s, BENCH_SIZE);
+		else
+			bs_memmove(d, s, BENCH_SIZE);
+		break;
+	}
+}
+
+/* MB/s */
+static double measure(int op, int old, unsigned int dalign,
+		      unsigned int salign)
+{
+	double start = now();
+	double elapsed;
+	unsigned int rounds = 0;
+
+	do {
+		run_op(op, old, dalign, salign);
+		rounds++;
+		elapsed = now() - start;
+	} while (elapsed < BENCH_TIME);
+
+	return (double)rounds * BENCH_SIZE / elapsed / 1e6;
+}
+
+static void bench(void)
+{
+	static const struct {
+		const char *name;
+		int op;
+		unsigned int dalign;
+		unsigned int salign;
+	} cases[] = {
+		{ "memcpy, both aligned",	OP_MEMCPY,  0, 0 },
+		{ "memcpy, dst +1 src +1",	OP_MEMCPY,  1, 1 },
+		{ "memcpy, dst +0 src +1",	OP_MEMCPY,  0, 1 },
+		{ "memcpy, dst +2 src +3",	OP_MEMCPY,  2, 3 },
+		{ "memset, aligned",		OP_MEMSET,  0, 0 },
+		{ "memset, dst +3",		OP_MEMSET,  3, 0 },
+		{ "memmove, backward aligned",	OP_MEMMOVE, 0, 0 },
+		{ "memmove, backward +1",	OP_MEMMOVE, 1, 0 },
+	};
+	double old_rate, new_rate;
+	unsigned int i;
+
+	bench_src = malloc(BENCH_SIZE + 256);
+	bench_dst = malloc(BENCH_SIZE + 256);
+	if (!bench_src || !bench_dst) {
+		printf("bench: out of memory\n");
+		exit(1);
+	}
+	fill_pattern(bench_src, BENCH_SIZE + 256, 1);
+	memset(bench_dst, 0, BENCH_SIZE + 256);
+
+	printf("%-28s %10s %10s %7s\n", "case", "old MB/s", "new MB/s",
+	       "ratio");
+	for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+		old_rate = measure(cases[i].op, 1, cases[i].dalign,
+				   cases[i].salign);
+		new_rate = measure(cases[i].op, 0, cases[i].dalign,
+				   cases[i].salign);
+		printf("%-28s %10.0f %10.0f %6.1fx\n", cases[i].name,
+		       old_rate, new_rate, new_rate / old_rate);
+	}
+
+	free(bench_src);
+	free(bench_dst);
+}
+
+int main(int argc, char **argv)
+{
+	check_memcpy();
+	check_memset();
+	check_memmove();
+
+	if (failures) {
+		printf("string_check: %d failures\n", failures);
+		return 1;
+	}
+	printf("string_check: memcpy, memset, memmove ok (alignments 0-%u, "
+	       "lengths 0-%u, overlaps up to %u bytes apart)\n",
+	       MAX_ALIGN - 1, MAX_LEN, MAX_DELTA);
+
+	if (argc > 1 && !strcmp(argv[1], "-n"))
+		return 0;
+
+	bench();
+
+	return 0;
+}
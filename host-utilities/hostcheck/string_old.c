@@ -0,0 +1,65 @@
+// Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+//
+// SPDX-License-Identifier: MIT
+
+/*
+ * The memcpy(), memset() and memmove() lib/string.c had before the word
+ * copies, built like the bootstrap code to serve as the timing baseline.
+ */
+
+void *old_memcpy(void *dst, const void *src, int cnt)
+{
+	char *d;
+	const char *s;
+	struct chunk {
+		unsigned int val[2];
+	};
+
+	const struct chunk *csrc = (const struct chunk *) src;
+	struct chunk *cdst = (struct chunk *)dst;
+
+	if (((unsigned long)src & 0xf) == 0 && ((unsigned long)dst & 0xf) == 0) {
+		while (cnt >= sizeof(struct chunk)) {
+			*cdst++ = *csrc++;
+			cnt -= sizeof(struct chunk);
+		}
+	}
+
+	d = (char *) cdst;
+	s = (const char *) csrc;
+
+	while (cnt--)
+		*d++ = *s++;
+
+	return dst;
+}
+
+void *old_memset(void *dst, int val, int cnt)
+{
+	char *d = (char *)dst;
+
+	while (cnt--)
+		*d++ = (char)val;
+
+	return dst;
+}
+
+void *old_memmove(void *dst, const void *src, unsigned int cnt)
+{
+	char *p, *s;
+
+	if (dst <= src) {
+		p = (char *)dst;
+		s = (char *)src;
+		while (cnt--)
+			*p++ = *s++;
+	} else {
+		p = (char *)dst + cnt;
+		s = (char *)src + cnt;
+		while (cnt--)
+			*--p = *--s;
+	}
+
+	return dst;
+}
+
@@ -85,4 +85,22 @@ int at91_aes_cmac(unsigned int data_length,
 		  at91_aes_key_size_t key_size,
 		  const unsigned int *key);
 
+/*
+ * Split CMAC, for data that is not available all at once: chain
+ * at91_aes_cbc_mac() over all the blocks but the last one, starting
+ * from a null IV and feeding each result back as the next IV, then
+ * call at91_aes_cmac_final() with the last block.
+ */
+int at91_aes_cbc_mac(unsigned int data_length,
+		     const void *data,
+		     unsigned int *mac,
+		     at91_aes_key_size_t key_size,
+		     const unsigned int *key,
+		     const unsigned int *iv);
+
+int at91_aes_cmac_final(const unsigned int *last_block,
+			unsigned int *cmac,
+			at91_aes_key_size_t key_size,
+			const unsigned int *key);
+
 #endif /* __AES_H__ */
@@ -34,6 +34,7 @@
 #define AT91C_DBGU_TXEN		(0x1UL << 6)
 #define AT91C_DBGU_TXDIS	(0x1UL << 7)
 #define AT91C_DBGU_RSTSTA	(0x1UL << 8)
+#define AT91C_US_FIFOEN		(0x1UL << 30)	/* FLEXCOM USART only */
 
 /* -------- DBGU_MR : (DBGU Offset: 0x4) Debug Unit Mode Register --------*/ 
 #define AT91C_DBGU_NBSTOP	(0x3UL << 12)
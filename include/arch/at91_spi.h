@@ -23,6 +23,8 @@
 #define AT91C_SPI_SPIDIS	(0x1UL <<  1)
 #define AT91C_SPI_SWRST		(0x1UL <<  7)
 #define AT91C_SPI_LASTXFER	(0x1UL << 24)
+#define AT91C_SPI_FIFOEN	(0x1UL << 30)
+#define AT91C_SPI_FIFODIS	(0x1UL << 31)
 
 /* -------- SPI_MR : (SPI Offset: 0x4) SPI Mode Register --------*/ 
 #define AT91C_SPI_MSTR		(0x1UL <<  0)
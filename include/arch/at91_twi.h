@@ -20,6 +20,11 @@
 #define TWI_IMR		0x2C	/* Interrupt Mask Register */
 #define TWI_RHR		0x30	/* Receive Holding Register */
 #define TWI_THR		0x34	/* Transmit Holding Register */
+/* 0x38 - 0x3C Reserved */
+#define TWI_ACR		0x40	/* Alternative Command Register */
+#define TWI_FMR		0x50	/* FIFO Mode Register */
+#define TWI_FLR		0x54	/* FIFO Level Register */
+#define TWI_FSR		0x60	/* FIFO Status Register */
 
 #define TWI_WPROT_MODE		0xE4	/* Protection Mode Register */
 #define TWI_WPROT_STATUS	0xE8	/* Protection Status Register */
@@ -34,6 +39,13 @@
 #define TWI_CR_SVDIS		(0x1UL << 5)	/* TWI Slave Mode Disabled */
 #define TWI_CR_QUICK		(0x1UL << 6)	/* SMBUS Quick Command */
 #define TWI_CR_SWRST		(0x1UL << 7)	/* Software Reset */
+#define TWI_CR_ACMEN		(0x1UL << 16)	/* Alternative Command Mode Enable */
+#define TWI_CR_ACMDIS		(0x1UL << 17)	/* Alternative Command Mode Disable */
+#define TWI_CR_THRCLR		(0x1UL << 24)	/* Transmit Holding Register Clear */
+#define TWI_CR_RHRCLR		(0x1UL << 25)	/* Receive Holding Register Clear */
+#define TWI_CR_LOCKCLR		(0x1UL << 26)	/* Lock Clear */
+#define TWI_CR_FIFOEN		(0x1UL << 28)	/* FIFO Enable */
+#define TWI_CR_FIFODIS		(0x1UL << 29)	/* FIFO Disable */
 
 /*-------- TWI_MMR : (Offset: 0x04) Control Register --------*/
 #define TWI_MMR_IADRSZ(isize)	(isize << 8)
@@ -58,5 +70,11 @@
 #define TWI_SR_ARBLST		(0x01UL	<< 9)
 #define TWI_SR_SCLWS		(0x01UL	<< 10)
 #define TWI_SR_EOSACC		(0x01UL	<< 11)
+#define TWI_SR_LOCK		(0x01UL	<< 23)
+
+/*-------- TWI_ACR : (Offset: 0x40) Alternative Command Register --------*/
+#define TWI_ACR_DATAL(len)	((len) & 0xff)
+#define TWI_ACR_DATAL_MAX	255
+#define TWI_ACR_DIR		(0x01UL << 8)
 
 #endif /* #ifndef __AT91_TWI_H__ */
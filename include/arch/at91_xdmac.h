@@ -98,6 +98,17 @@
 #define XDMAC_CBC_BLEN_MASK	(0xFFF << 0)
 #define XDMAC_CBC_BLEN(i)	(((i) << 0) & XDMAC_CBC_BLEN_MASK)
 
+/*-------- XDMAC_MBR_UBC: Linked list descriptor microblock control -------*/
+#define XDMAC_MBR_UBC_UBLEN_MASK	(0xFFFFFF << 0)
+#define XDMAC_MBR_UBC_NDE		(0x1 << 24)
+#define XDMAC_MBR_UBC_NSEN		(0x1 << 25)
+#define XDMAC_MBR_UBC_NDEN		(0x1 << 26)
+#define XDMAC_MBR_UBC_NVIEW_MASK	(0x3 << 27)
+#define XDMAC_MBR_UBC_NVIEW_NDV0	(0x0 << 27)
+#define XDMAC_MBR_UBC_NVIEW_NDV1	(0x1 << 27)
+#define XDMAC_MBR_UBC_NVIEW_NDV2	(0x2 << 27)
+#define XDMAC_MBR_UBC_NVIEW_NDV3	(0x3 << 27)
+
 /*-------- XDMAC_CC: (Offset: 0x78) -------*/
 #define XDMAC_CC_TYPE_PER_TRAN	(0x1 << 0)
 #define XDMAC_CC_TYPE_MEM_TRAN	(0x0 << 0)
@@ -202,6 +202,35 @@
 #define PMECC_GF_TABLE_1024_ALPHA_OFFSET	0x50000
 #define PMECC_GF_TABLE_1024_INDEX_OFFSET	0x48000
 
+/*
+ * SPI
+ */
+#define AT91C_SPI_FIFO_SIZE	16
+
+/*
+ * XDMAC peripheral hardware request IDs
+ */
+#define AT91C_XDMAC_PERID_TWI0_TX	0
+#define AT91C_XDMAC_PERID_TWI0_RX	1
+#define AT91C_XDMAC_PERID_TWI1_TX	2
+#define AT91C_XDMAC_PERID_TWI1_RX	3
+#define AT91C_XDMAC_PERID_SPI0_TX	6
+#define AT91C_XDMAC_PERID_SPI0_RX	7
+#define AT91C_XDMAC_PERID_SPI1_TX	8
+#define AT91C_XDMAC_PERID_SPI1_RX	9
+#define AT91C_XDMAC_PERID_FLEXCOM0_TX	11
+#define AT91C_XDMAC_PERID_FLEXCOM0_RX	12
+#define AT91C_XDMAC_PERID_FLEXCOM1_TX	13
+#define AT91C_XDMAC_PERID_FLEXCOM1_RX	14
+#define AT91C_XDMAC_PERID_FLEXCOM2_TX	15
+#define AT91C_XDMAC_PERID_FLEXCOM2_RX	16
+#define AT91C_XDMAC_PERID_FLEXCOM3_TX	17
+#define AT91C_XDMAC_PERID_FLEXCOM3_RX	18
+#define AT91C_XDMAC_PERID_FLEXCOM4_TX	19
+#define AT91C_XDMAC_PERID_FLEXCOM4_RX	20
+#define AT91C_XDMAC_PERID_AES_TX	26
+#define AT91C_XDMAC_PERID_AES_RX	27
+
 /*
  * Chip Identifier (CHIPID)
  */
@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef __BOOTSTAGE_H__
+#define __BOOTSTAGE_H__
+
+/*
+ * Boot stages, in the order they are normally reached. Each one is
+ * marked when the corresponding phase completes, so the time spent in
+ * a phase is the difference between its mark and the previous one.
+ */
+enum bootstage_id {
+	BOOTSTAGE_CLOCK,	/* clocks set up, timer started */
+	BOOTSTAGE_DRAM,		/* external memory initialized */
+	BOOTSTAGE_HW_INIT,	/* hw_init() returned */
+	BOOTSTAGE_BOARD_INFO,	/* board hw info loaded, PMIC set up */
+	BOOTSTAGE_MEDIA_INIT,	/* boot media identified */
+	BOOTSTAGE_IMAGE_READ,	/* image copied to memory */
+	BOOTSTAGE_SECURE_CHECK,	/* image authenticated and decrypted */
+	BOOTSTAGE_FDT_FIXUP,	/* device tree fixed up */
+	BOOTSTAGE_HANDOFF,	/* about to jump to the next stage */
+
+	BOOTSTAGE_COUNT,
+};
+
+#ifdef CONFIG_BOOTSTAGE
+extern void bootstage_mark(enum bootstage_id id);
+extern void bootstage_report(void);
+#ifdef CONFIG_OF_LIBFDT
+extern int bootstage_fdt_fixup(void *blob);
+#endif
+#else
+static inline void bootstage_mark(enum bootstage_id id) { }
+static inline void bootstage_report(void) { }
+#ifdef CONFIG_OF_LIBFDT
+static inline int bootstage_fdt_fixup(void *blob) { return 0; }
+#endif
+#endif
+
+#endif /* #ifndef __BOOTSTAGE_H__ */
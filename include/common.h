@@ -72,6 +72,8 @@ extern void init_load_image(struct image_info *image);
 extern int load_kernel(struct image_info *image);
 
 extern int kernel_size(unsigned char *addr);
+
+extern void kernel_placement(struct image_info *image);
 #endif
 
 extern void load_image_done(int retval);
@@ -7,10 +7,30 @@
 #ifndef __DIV_H__
 #define __DIV_H__
 
-extern unsigned int div(unsigned int dividend, unsigned int divisor);
-extern unsigned int mod(unsigned int dividend, unsigned int divisor);
+extern unsigned int udiv32(unsigned int dividend, unsigned int divisor);
+extern unsigned int umod32(unsigned int dividend, unsigned int divisor);
 extern int division(unsigned int dividend,
 		unsigned int divisor,
 		unsigned int *quotient,
 		unsigned int *remainder);
+
+/* A constant power of two divisor is resolved at compile time */
+#define DIV_IS_CONST_POW2(x)	\
+	(__builtin_constant_p(x) && (x) && !((x) & ((x) - 1)))
+
+static inline unsigned int div(unsigned int dividend, unsigned int divisor)
+{
+	if (DIV_IS_CONST_POW2(divisor))
+		return dividend >> (31 - __builtin_clz(divisor));
+
+	return udiv32(dividend, divisor);
+}
+
+static inline unsigned int mod(unsigned int dividend, unsigned int divisor)
+{
+	if (DIV_IS_CONST_POW2(divisor))
+		return dividend & (divisor - 1);
+
+	return umod32(dividend, divisor);
+}
 #endif
@@ -8,6 +8,9 @@
 #define __DS24XX_H__
 
 extern unsigned int enumerate_all_rom(void);
+extern void enumerate_rom_start(void);
+extern int enumerate_rom_next(void);
+extern unsigned int enumerate_rom_count(void);
 extern int ds24xx_read_memory(int chip_index, unsigned char addrh,
 				unsigned char addrl, int len, unsigned char *p);
 extern void one_wire_hw_init(void);
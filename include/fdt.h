@@ -10,6 +10,8 @@
 extern unsigned int of_get_dt_total_size(void *blob);
 extern int check_dt_blob_valid(void *blob);
 extern int fixup_chosen_node(void *blob, char *bootargs);
+extern int fixup_chosen_property(void *blob, const char *name,
+				 void *value, int valuelen);
 extern int fixup_memory_node(void *blob,
 				unsigned int *mem_bank,
 				unsigned int *mem_bank2,
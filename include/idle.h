@@ -0,0 +1,37 @@
+/*
+ * Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef __IDLE_H__
+#define __IDLE_H__
+
+/*
+ * Background work done while the CPU spins in mdelay(), task_delay() or
+ * on a deadline. A driver with something to move along without blocking,
+ * such as the buffered console, registers a hook; those wait loops call
+ * idle_poll(). udelay() does not, as it times bit-banged bus slots. The
+ * hook must not wait itself.
+ */
+typedef void (*idle_hook_t)(void);
+
+#ifdef CONFIG_IDLE_HOOK
+extern idle_hook_t idle_hook;
+
+static inline void idle_set_hook(idle_hook_t hook)
+{
+	idle_hook = hook;
+}
+
+static inline void idle_poll(void)
+{
+	if (idle_hook)
+		idle_hook();
+}
+#else
+static inline void idle_set_hook(idle_hook_t hook) { }
+static inline void idle_poll(void) { }
+#endif
+
+#endif /* #ifndef __IDLE_H__ */
@@ -58,4 +58,9 @@ void dcache_invalidate(void);
  */
 void dcache_invalidate_region(unsigned int start, unsigned int end);
 
+/**
+ * \brief Clean the data cache region.
+ */
+void dcache_clean_region(unsigned int start, unsigned int end);
+
 #endif /* L1CACHE_H_ */
@@ -0,0 +1,20 @@
+/*
+ * Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef __LZ4_H__
+#define __LZ4_H__
+
+/*
+ * Decompress a LZ4 frame, or a legacy "lz4 -l" stream, from @src to
+ * @dst. @dstlen holds the room available at @dst on entry and the
+ * decompressed length on return. The output never goes past that room,
+ * whatever the input. Returns 0 on success, -1 on a corrupted or
+ * unsupported stream.
+ */
+extern int lz4_decompress(const void *src, unsigned int srclen,
+			  void *dst, unsigned int *dstlen);
+
+#endif /* #ifndef __LZ4_H__ */
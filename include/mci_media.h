@@ -119,8 +119,11 @@
 #define SD_RESP_TYPE_R6	0x60
 #define SD_RESP_TYPE_R7	0x70
 
+/* Number of slots of the ADMA2 descriptor ring, including the link slot */
 #define ADMA2_MAX_NUM_DESC	64
-#define ADMA2_MAX_DESC_BLOCKS	128
+
+/* Largest block count the 16-bit block count registers can program */
+#define SD_MAX_BLOCK_COUNT	0xffff
 
 struct sd_command {
 	unsigned int cmd;
@@ -274,6 +277,7 @@ struct sd_card {
 	unsigned int	read_bl_len;
 	unsigned int	configured_bus_w; /* bus width which we configured */
 	unsigned int	v1v8; /* is this card running in 1V8 mode */
+	unsigned int	known_bus_w; /* bus width found by a previous boot */
 
 	struct sd_host	*host;
 
@@ -11,4 +11,14 @@ void mmu_disable(void);
 
 void mmu_configure(void *tlb);
 
+#ifdef CONFIG_MMU
+/* Build the translation table, turn the MMU and the caches on */
+void mmu_caches_enable(void);
+/* Write back and drop the caches, turn them and the MMU off */
+void mmu_caches_disable(void);
+#else
+static inline void mmu_caches_enable(void) { }
+static inline void mmu_caches_disable(void) { }
+#endif
+
 #endif	/* #ifndef __MMU_H__ */
@@ -12,6 +12,12 @@ int publ_idone(void);
 int publ_start(void);
 int publ_train(void);
 
+#ifdef CONFIG_PUBL_TRAINING_CACHE
+int publ_restore_training(void);
+void publ_save_training(void);
+void publ_drop_training(void);
+#endif
+
 #ifdef CONFIG_BACKUP_MODE
 int publ_bypass_zq_calibration(void);
 int publ_override_zq_calibration(void);
@@ -11,6 +11,9 @@ extern void cpu_reset(void);
 
 extern void rstc_external_reset(void);
 
+extern unsigned int rstc_get_reset_type(void);
+extern int rstc_is_warm_reset(void);
+
 extern void rstc_ddr_phy_rst_deassert(void);
 extern void rstc_ddr_rst_deassert(void);
 extern void rstc_ddr_assert(void);
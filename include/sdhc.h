@@ -15,4 +15,15 @@ struct adma_desc {
 	unsigned int addr;
 } __attribute__ ((packed, aligned(4)));
 
+/* ADMA2 descriptor attributes (cmd field) */
+#define ADMA2_ATTR_VALID	(0x1 << 0)
+#define ADMA2_ATTR_END		(0x1 << 1)
+#define ADMA2_ATTR_INT		(0x1 << 2)
+#define ADMA2_ATTR_ACT_NOP	(0x0 << 4)
+#define ADMA2_ATTR_ACT_TRAN	(0x2 << 4)
+#define ADMA2_ATTR_ACT_LINK	(0x3 << 4)
+
+/* A length of 0 in a transfer descriptor stands for 64 KiB */
+#define ADMA2_DESC_MAX_LEN	0x10000
+
 #endif
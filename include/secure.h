@@ -21,6 +21,28 @@ typedef struct at91_secure_header {
 
 int secure_check(void *data);
 
+#ifdef CONFIG_SECURE_STREAM
+#define SECURE_STREAM_CHUNK	CONFIG_SECURE_STREAM_CHUNK
+
+/*
+ * secure_stream_start() arms the streaming check for an image to be
+ * loaded at @data, the loaders then call secure_stream_update() with the
+ * number of bytes already in memory (0 when they start over) and
+ * secure_check(@data) completes the check once the image is loaded.
+ * When the image fails to load, secure_stream_abort() wipes what was
+ * already decrypted and the keys instead.
+ */
+void secure_stream_start(void *data);
+void secure_stream_update(void *data, unsigned int loaded);
+void secure_stream_abort(void);
+#else
+#define SECURE_STREAM_CHUNK	0xffffffff
+
+static inline void secure_stream_start(void *data) { }
+static inline void secure_stream_update(void *data, unsigned int loaded) { }
+static inline void secure_stream_abort(void) { }
+#endif
+
 #if defined(CONFIG_OCMS_STATIC)
 void ocms_init_keys(void);
 void ocms_enable(void);
@@ -31,5 +31,6 @@ extern int at91_spi_init(unsigned int pcs,
 extern void at91_spi_write_data(unsigned short data);
 extern unsigned int at91_spi_read_spi(void);
 extern unsigned int at91_spi_read_sr(void);
+extern int at91_spi_read_bulk(unsigned char *buf, unsigned int len);
 
 #endif	/* #ifndef __SPI_H__ */
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef __TASK_H__
+#define __TASK_H__
+
+#include "timer.h"
+
+/*
+ * Run-to-completion boot tasks, for the hardware that has to be left
+ * alone for a while between two accesses.
+ *
+ * The step function of a task does a bounded amount of work each time it
+ * is called and returns either TASK_DONE or task_sleep(), which schedules
+ * the next call. The first step runs from task_start(); the next ones run
+ * when the foreground code waits in task_delay() or task_wait(), and only
+ * there: udelay() and the driver timeouts never run a step, so tight
+ * bit timings are not disturbed. Steps must not wait for other tasks.
+ */
+#define TASK_DONE	0
+#define TASK_WAIT	1
+
+struct task {
+	const char *name;
+	int (*step)(struct task *task);
+	unsigned int state;		/* private to the step function */
+	unsigned long long wake;	/* ticks */
+	int status;			/* idle, pending or finished */
+	struct task *next;
+};
+
+static inline int task_sleep(struct task *task, unsigned int usec)
+{
+	task->wake = deadline_from_us(usec);
+
+	return TASK_WAIT;
+}
+
+extern void task_start(struct task *task);
+extern void task_wait(struct task *task);
+extern void task_wait_all(void);
+extern void task_delay(unsigned int usec);
+
+#endif /* #ifndef __TASK_H__ */
@@ -7,12 +7,44 @@
 #ifndef __PIT_TIMER_H__
 #define __PIT_TIMER_H__
 
+#include "idle.h"
+
 extern int timer_init(void);
 
 extern void udelay(unsigned int usec);
 extern void mdelay(unsigned int msec);
 
+/*
+ * Monotonic 64-bit time since timer_init(), in timer ticks or in
+ * microseconds.
+ */
+extern unsigned long long get_ticks(void);
+extern unsigned long long get_time_us(void);
+extern unsigned int ticks_to_us(unsigned long long ticks);
+extern unsigned long long us_to_ticks(unsigned long long usec);
+
 extern int start_interval_timer(void);
 extern int wait_interval_timer(unsigned int usec);
 
+/*
+ * Deadlines for the polling loops, kept in ticks so that checking one
+ * is a single counter read:
+ *
+ *	deadline = deadline_from_us(1000);
+ *	while (!ready())
+ *		if (deadline_expired(deadline))
+ *			return -1;
+ */
+static inline unsigned long long deadline_from_us(unsigned int usec)
+{
+	return get_ticks() + us_to_ticks(usec);
+}
+
+static inline int deadline_expired(unsigned long long deadline)
+{
+	idle_poll();
+
+	return get_ticks() >= deadline;
+}
+
 #endif /* #ifndef __PIT_TIMER_H__ */
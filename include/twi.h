@@ -9,6 +9,25 @@
 
 extern unsigned int twi_init_done;
 
+#define TWI_MSG_READ	0x01
+
+/*
+ * One transaction of a queue passed to twi_transfer(): START, device
+ * address, @iaddr_size bytes of internal address, @bytes of data, STOP.
+ */
+struct twi_msg {
+	unsigned char device_addr;
+	unsigned char iaddr_size;
+	unsigned char flags;
+	unsigned int internal_addr;
+	unsigned char *data;
+	unsigned int bytes;
+};
+
+/* Run the queued messages in order, stop at the first failure */
+extern int twi_transfer(unsigned int twi_no, struct twi_msg *msgs,
+			unsigned int count);
+
 extern int twi_read(unsigned int twi_no, unsigned char device_addr,
 		unsigned int internal_addr, unsigned char iaddr_size,
 		unsigned char *data, unsigned int bytes);
@@ -28,6 +28,12 @@ struct umctl2_config_state
 	int (*phy_zq_recalibrate)(void);
 		/* Pointer to phy traning corrupted data restore function. */
 	int (*phy_train_corrupted_data_restore)(void);
+		/* Pointer to saved training restore function, 0 if applied */
+	int (*phy_restore_training)(void);
+		/* Pointer to training results save function */
+	void (*phy_save_training)(void);
+		/* Pointer to function rejecting the restored training results */
+	void (*phy_drop_training)(void);
 	/* Policies configuration */
 		/* pageclose mechanism: precharge banks only after pageclose_timer
 		expires, after there are no more page hit transactions in CAM.
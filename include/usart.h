@@ -15,4 +15,10 @@ extern void usart_init(unsigned int);
 extern void usart_puts(const char *ptr);
 extern char usart_getc(void);
 
+#ifdef CONFIG_CONSOLE_BUFFER
+extern void usart_flush(void);
+#else
+static inline void usart_flush(void) { }
+#endif
+
 #endif /* __USART_H__ */
@@ -48,13 +48,44 @@ struct xdmac_transfer_cfg {
 	unsigned int len;
 };
 
+/*
+ * Split of a memory to memory copy: the head and tail bytes are left
+ * to the CPU so that the DMA part is a whole number of data width
+ * beats between aligned addresses.
+ */
+struct xdmac_plan {
+	unsigned int head;
+	unsigned int len;
+	unsigned int tail;
+};
+
+/* Linked list descriptor, view 1: both addresses are reloaded */
+struct xdmac_desc {
+	unsigned int mbr_nda;
+	unsigned int mbr_ubc;
+	unsigned int mbr_sa;
+	unsigned int mbr_da;
+};
+
 /* functions */
+extern int xdmac_request_channel(struct xdmac_hwcfg *hwcfg);
 extern int xdmac_configure_transfer(struct xdmac_hwcfg *hwcfg,
 		struct xdmac_cfg *cfg);
 extern int xdmac_transfer_start(struct xdmac_hwcfg *hwcfg,
 		struct xdmac_transfer_cfg *cfg);
 extern void xdmac_transfer_stop(struct xdmac_hwcfg *hwcfg);
+extern int xdmac_transfer_poll(struct xdmac_hwcfg *hwcfg);
 extern int xdmac_transfer_wait_for_completion(struct xdmac_hwcfg *hwcfg);
+extern int xdmac_prepare_list(struct xdmac_desc *desc, unsigned int num_desc,
+		struct xdmac_cfg *cfg, struct xdmac_transfer_cfg *transfer_cfg);
+extern int xdmac_transfer_start_list(struct xdmac_hwcfg *hwcfg,
+		struct xdmac_desc *desc);
+extern int xdmac_list_wait_for_completion(struct xdmac_hwcfg *hwcfg);
+extern void xdmac_plan_mem_transfer(struct xdmac_plan *plan,
+		struct xdmac_cfg *cfg, const void *src, void *dst,
+		unsigned int len);
+extern int xdmac_memcpy(struct xdmac_hwcfg *hwcfg, void *dst,
+		const void *src, unsigned int len);
 
 #endif /* XDMAC_H */
 
@@ -2,73 +2,86 @@
 //
 // SPDX-License-Identifier: MIT
 
+#include "div.h"
+
+#ifndef __ARM_FEATURE_IDIV
+/*
+ * Restoring division, one quotient bit per step. The divisor is first
+ * lined up with the leading bit of the dividend, so the loop only runs
+ * for as many bits as the quotient can have.
+ */
+static unsigned int udiv_soft(unsigned int dividend, unsigned int divisor)
+{
+	unsigned int quotient = 0;
+	unsigned int bit;
+	int shift;
+
+	/* powers of two, e.g. page and sector sizes */
+	if (!(divisor & (divisor - 1)))
+		return dividend >> (31 - __builtin_clz(divisor));
+
+	if (dividend < divisor)
+		return 0;
+
+	shift = __builtin_clz(divisor) - __builtin_clz(dividend);
+	divisor <<= shift;
+
+	/* no branch on the quotient bits, they do not predict */
+	for (; shift >= 0; shift--) {
+		bit = (dividend >= divisor);
+		quotient = (quotient << 1) | bit;
+		dividend -= divisor & -bit;
+		divisor >>= 1;
+	}
+
+	return quotient;
+}
+#endif
+
 int division(unsigned int dividend,
 		unsigned int divisor,
 		unsigned int *quotient,
 		unsigned int *remainder)
 {
-	unsigned int shift;
-	unsigned int divisor_shift;
-	unsigned int factor = 0;
-	unsigned char end_flag = 0;
+	unsigned int factor;
 
 	if (!divisor)
 		return 0xffffffff;
 
-	if (dividend < divisor) {
-		*quotient = 0;
-		*remainder = dividend;
-		return 0;
-	}
-
-	while (dividend >= divisor) {
-		for (shift = 0, divisor_shift = divisor;
-			dividend >= divisor_shift;
-			divisor_shift <<= 1, shift++) {
-			if (dividend - divisor_shift < divisor_shift) {
-				factor += 1 << shift;
-				dividend -= divisor_shift;
-				end_flag = 1;
-				break;
-			}
-		}
-
-		if (end_flag)
-			continue;
-
-		factor += 1 << (shift - 1);
-		dividend -= divisor_shift >> 1;
-	}
+#ifdef __ARM_FEATURE_IDIV
+	/* Cortex-A7 has UDIV, the compiler emits it inline */
+	factor = dividend / divisor;
+#else
+	factor = udiv_soft(dividend, divisor);
+#endif
 
 	if (quotient)
 		*quotient = factor;
 
 	if (remainder)
-		*remainder = dividend;
+		*remainder = dividend - factor * divisor;
 
 	return 0;
 }
 
-unsigned int div(unsigned int dividend, unsigned int divisor)
+unsigned int udiv32(unsigned int dividend, unsigned int divisor)
 {
 	unsigned int quotient = 0;
-	unsigned int remainder = 0;
 	int ret;
 
-	ret = division(dividend, divisor, &quotient, &remainder);
+	ret = division(dividend, divisor, &quotient, 0);
 	if (ret)
 		return 0xffffffff;
 
 	return quotient;
 }
 
-unsigned int mod(unsigned int dividend, unsigned int divisor)
+unsigned int umod32(unsigned int dividend, unsigned int divisor)
 {
-	unsigned int quotient = 0;
 	unsigned int remainder = 0;
 	int ret;
 
-	ret = division(dividend, divisor, &quotient, &remainder);
+	ret = division(dividend, divisor, 0, &remainder);
 	if (ret)
 		return 0xffffffff;
 
@@ -567,6 +567,28 @@ int fixup_chosen_node(void *blob, char *bootargs)
 	return 0;
 }
 
+/* Set an arbitrary property of the /chosen node, adding it if needed */
+int fixup_chosen_property(void *blob, const char *name,
+			  void *value, int valuelen)
+{
+	int nodeoffset;
+	int ret;
+
+	ret = of_get_node_offset(blob, "chosen", &nodeoffset);
+	if (ret) {
+		dbg_info("DT: doesn't support add node (chosen)\n");
+		return ret;
+	}
+
+	ret = of_set_property(blob, nodeoffset, name, value, valuelen);
+	if (ret) {
+		dbg_info("DT: could not set %s property\n", name);
+		return ret;
+	}
+
+	return 0;
+}
+
 /* The /memory node
  * Required properties:
  * - device_type: has to be "memory".
@@ -13,4 +13,5 @@ COBJS-y		+= $(LIB)/div.o
 COBJS-y		+= $(LIB)/consttime_memequal.o
 
 COBJS-$(CONFIG_CRC32)	+= $(LIB)/crc32.o
+COBJS-$(CONFIG_LZ4)	+= $(LIB)/lz4.o
 COBJS-$(CONFIG_OF_LIBFDT) += $(LIB)/fdt.o
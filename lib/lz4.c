@@ -0,0 +1,235 @@
+// Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+//
+// SPDX-License-Identifier: MIT
+
+#include "string.h"
+#include "lz4.h"
+
+#define LZ4_FRAME_MAGIC		0x184d2204
+#define LZ4_LEGACY_MAGIC	0x184c2102
+
+/* Frame descriptor flags */
+#define LZ4_FLG_VERSION_MASK	(0x3 << 6)
+#define LZ4_FLG_VERSION_01	(0x1 << 6)
+#define LZ4_FLG_BLOCK_CHECKSUM	(0x1 << 4)
+#define LZ4_FLG_CONTENT_SIZE	(0x1 << 3)
+#define LZ4_FLG_DICT_ID		(0x1 << 0)
+
+#define LZ4_BLOCK_UNCOMPRESSED	0x80000000
+
+#define LZ4_MIN_MATCH		4
+
+static unsigned int lz4_get_le32(const unsigned char *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+/* Add the 255-terminated extension bytes of a literal or match length */
+static int lz4_get_length(const unsigned char **ip, const unsigned char *iend,
+			  unsigned int *len)
+{
+	unsigned int byte;
+
+	do {
+		if (*ip >= iend)
+			return -1;
+
+		byte = *(*ip)++;
+		*len += byte;
+	} while (byte == 255);
+
+	return 0;
+}
+
+/*
+ * Decode one block of sequences to @op. Matches may reach back to
+ * @ostart, the start of the whole output, since the blocks of a frame
+ * are allowed to depend on the previous ones.
+ */
+static int lz4_decode_block(const unsigned char *ip, unsigned int srclen,
+			    unsigned char *ostart, unsigned char **opp,
+			    unsigned char *oend)
+{
+	const unsigned char *iend = ip + srclen;
+	const unsigned char *match;
+	unsigned char *op = *opp;
+	unsigned int token, len, offset;
+
+	for (;;) {
+		if (ip >= iend)
+			return -1;
+		token = *ip++;
+
+		/* literals */
+		len = token >> 4;
+		if (len == 15 && lz4_get_length(&ip, iend, &len))
+			return -1;
+
+		if (len > (unsigned int)(iend - ip) ||
+		    len > (unsigned int)(oend - op))
+			return -1;
+
+		memcpy(op, ip, len);
+		op += len;
+		ip += len;
+
+		/* the last sequence has no match */
+		if (ip == iend)
+			break;
+
+		/* match */
+		if (iend - ip < 2)
+			return -1;
+		offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+
+		if (!offset || offset > (unsigned int)(op - ostart))
+			return -1;
+
+		len = token & 0xf;
+		if (len == 15 && lz4_get_length(&ip, iend, &len))
+			return -1;
+		len += LZ4_MIN_MATCH;
+
+		if (len > (unsigned int)(oend - op))
+			return -1;
+
+		match = op - offset;
+		if (offset >= len) {
+			memcpy(op, match, len);
+			op += len;
+		} else {
+			/* the match repeats the bytes being written */
+			while (len--)
+				*op++ = *match++;
+		}
+	}
+
+	*opp = op;
+
+	return 0;
+}
+
+static int lz4_decode_frame(const unsigned char *ip, const unsigned char *iend,
+			    unsigned char *ostart, unsigned char **opp,
+			    unsigned char *oend)
+{
+	unsigned int flg, size;
+	unsigned int header_len = 3;	/* FLG, BD and HC */
+
+	if (iend - ip < 3)
+		return -1;
+
+	flg = ip[0];
+	if ((flg & LZ4_FLG_VERSION_MASK) != LZ4_FLG_VERSION_01)
+		return -1;
+
+	/* there is no way to get a preset dictionary here */
+	if (flg & LZ4_FLG_DICT_ID)
+		return -1;
+
+	if (flg & LZ4_FLG_CONTENT_SIZE)
+		header_len += 8;
+
+	if ((unsigned int)(iend - ip) < header_len)
+		return -1;
+	ip += header_len;
+
+	/*
+	 * The block and content checksums are skipped, not verified: a
+	 * corrupted stream is only caught when it breaks the format or
+	 * the bounds. Use CONFIG_SECURE to authenticate the image.
+	 */
+	for (;;) {
+		if (iend - ip < 4)
+			return -1;
+		size = lz4_get_le32(ip);
+		ip += 4;
+
+		if (!size)
+			break;
+
+		if (size & LZ4_BLOCK_UNCOMPRESSED) {
+			size &= ~LZ4_BLOCK_UNCOMPRESSED;
+			if (size > (unsigned int)(iend - ip) ||
+			    size > (unsigned int)(oend - *opp))
+				return -1;
+
+			memcpy(*opp, ip, size);
+			*opp += size;
+		} else {
+			if (size > (unsigned int)(iend - ip))
+				return -1;
+
+			if (lz4_decode_block(ip, size, ostart, opp, oend))
+				return -1;
+		}
+		ip += size;
+
+		if (flg & LZ4_FLG_BLOCK_CHECKSUM)
+			ip += 4;
+	}
+
+	return 0;
+}
+
+/* Legacy format of "lz4 -l", as used by the kernel build */
+static int lz4_decode_legacy(const unsigned char *ip, const unsigned char *iend,
+			     unsigned char *ostart, unsigned char **opp,
+			     unsigned char *oend)
+{
+	unsigned int size;
+
+	while (iend - ip >= 4) {
+		size = lz4_get_le32(ip);
+
+		/* concatenated stream */
+		if (size == LZ4_LEGACY_MAGIC)
+			break;
+		ip += 4;
+
+		/* the uncompressed size appended by the kernel build */
+		if (ip == iend)
+			break;
+
+		if (size > (unsigned int)(iend - ip))
+			return -1;
+
+		if (lz4_decode_block(ip, size, ostart, opp, oend))
+			return -1;
+		ip += size;
+	}
+
+	return 0;
+}
+
+int lz4_decompress(const void *src, unsigned int srclen,
+		   void *dst, unsigned int *dstlen)
+{
+	const unsigned char *ip = src;
+	const unsigned char *iend = ip + srclen;
+	unsigned char *ostart = dst;
+	unsigned char *op = ostart;
+	unsigned char *oend = ostart + *dstlen;
+	unsigned int magic;
+
+	if (srclen < 4)
+		return -1;
+
+	magic = lz4_get_le32(ip);
+	ip += 4;
+
+	if (magic == LZ4_FRAME_MAGIC) {
+		if (lz4_decode_frame(ip, iend, ostart, &op, oend))
+			return -1;
+	} else if (magic == LZ4_LEGACY_MAGIC) {
+		if (lz4_decode_legacy(ip, iend, ostart, &op, oend))
+			return -1;
+	} else {
+		return -1;
+	}
+
+	*dstlen = op - ostart;
+
+	return 0;
+}
@@ -5,28 +5,92 @@
 #include "string.h"
 #include "common.h"
 
+/*
+ * The block moves below work on whole words, 32 bytes per iteration so
+ * that the compiler can turn them into LDM/STM bursts. Unaligned access
+ * is disabled, so both pointers are brought to a word boundary first and
+ * a source with a different alignment is merged from aligned loads. On
+ * the Cortex-A cores, the source is prefetched ahead with PLD.
+ */
+typedef unsigned int __attribute__((__may_alias__)) word_t;
+
+#define WORD_MASK	(sizeof(word_t) - 1)
+#define BLOCK_SIZE	(8 * sizeof(word_t))
+
+/* copies shorter than this are not worth the alignment fix-up */
+#define SMALL_COPY	16
+
+#if defined(CONFIG_CORE_CORTEX_A5) || defined(CONFIG_CORE_CORTEX_A7)
+#define prefetch(p)	__builtin_prefetch(p)
+#else
+#define prefetch(p)	do { } while (0)
+#endif
+
+/* Word copy, dst and src aligned, cnt a multiple of the word size */
+static void copy_words(word_t *d, const word_t *s, unsigned int cnt)
+{
+	word_t w0, w1, w2, w3, w4, w5, w6, w7;
+
+	for (; cnt >= BLOCK_SIZE; cnt -= BLOCK_SIZE) {
+		prefetch(s + 16);
+		w0 = s[0]; w1 = s[1]; w2 = s[2]; w3 = s[3];
+		w4 = s[4]; w5 = s[5]; w6 = s[6]; w7 = s[7];
+		d[0] = w0; d[1] = w1; d[2] = w2; d[3] = w3;
+		d[4] = w4; d[5] = w5; d[6] = w6; d[7] = w7;
+		s += 8;
+		d += 8;
+	}
+
+	for (; cnt; cnt -= sizeof(word_t))
+		*d++ = *s++;
+}
+
+/*
+ * Word copy from a misaligned source: every destination word is merged
+ * from the two aligned source words it straddles (little endian). Only
+ * the words holding requested bytes are loaded.
+ */
+static void copy_words_shifted(word_t *d, const unsigned char *src,
+			       unsigned int cnt)
+{
+	unsigned int shr = ((unsigned long)src & WORD_MASK) * 8;
+	unsigned int shl = 32 - shr;
+	const word_t *s = (const word_t *)((unsigned long)src & ~WORD_MASK);
+	word_t w0, w1;
+
+	w0 = *s++;
+	for (; cnt; cnt -= sizeof(word_t)) {
+		prefetch(s + 16);
+		w1 = *s++;
+		*d++ = (w0 >> shr) | (w1 << shl);
+		w0 = w1;
+	}
+}
+
 void *memcpy(void *dst, const void *src, int cnt)
 {
-	char *d;
-	const char *s;
-	struct chunk {
-		unsigned long val[2];
-	};
-
-	const struct chunk *csrc = (const struct chunk *) src;
-	struct chunk *cdst = (struct chunk *)dst;
-
-	if (((unsigned long)src & 0xf) == 0 && ((unsigned long)dst & 0xf) == 0) {
-		while (cnt >= sizeof(struct chunk)) {
-			*cdst++ = *csrc++;
-			cnt -= sizeof(struct chunk);
+	unsigned char *d = (unsigned char *)dst;
+	const unsigned char *s = (const unsigned char *)src;
+	unsigned int words;
+
+	if (cnt >= SMALL_COPY) {
+		while ((unsigned long)d & WORD_MASK) {
+			*d++ = *s++;
+			cnt--;
 		}
-	}
 
-	d = (char *) cdst;
-	s = (const char *) csrc;
+		words = cnt & ~WORD_MASK;
+		if ((unsigned long)s & WORD_MASK)
+			copy_words_shifted((word_t *)d, s, words);
+		else
+			copy_words((word_t *)d, (const word_t *)s, words);
 
-	while (cnt--)
+		d += words;
+		s += words;
+		cnt -= words;
+	}
+
+	while (cnt-- > 0)
 		*d++ = *s++;
 
 	return dst;
@@ -34,10 +98,34 @@ void *memcpy(void *dst, const void *src, int cnt)
 
 void *memset(void *dst, int val, int cnt)
 {
-	char *d = (char *)dst;
+	unsigned char *d = (unsigned char *)dst;
+	word_t *wd;
+	word_t w;
+
+	if (cnt >= SMALL_COPY) {
+		while ((unsigned long)d & WORD_MASK) {
+			*d++ = (unsigned char)val;
+			cnt--;
+		}
 
-	while (cnt--)
-		*d++ = (char)val;
+		w = (unsigned char)val;
+		w |= w << 8;
+		w |= w << 16;
+
+		wd = (word_t *)d;
+		for (; cnt >= BLOCK_SIZE; cnt -= BLOCK_SIZE) {
+			wd[0] = w; wd[1] = w; wd[2] = w; wd[3] = w;
+			wd[4] = w; wd[5] = w; wd[6] = w; wd[7] = w;
+			wd += 8;
+		}
+		for (; cnt >= sizeof(word_t); cnt -= sizeof(word_t))
+			*wd++ = w;
+
+		d = (unsigned char *)wd;
+	}
+
+	while (cnt-- > 0)
+		*d++ = (unsigned char)val;
 
 	return dst;
 }
@@ -169,20 +257,37 @@ void *memchr(void *src, int val, unsigned int cnt)
 
 void *memmove(void *dst, const void *src, unsigned int cnt)
 {
-	char *p, *s;
-
-	if (dst <= src) {
-		p = (char *)dst;
-		s = (char *)src;
-		while (cnt--)
-			*p++ = *s++;
-		}
-	else {
-		p = (char *)dst + cnt;
-		s = (char *)src + cnt;
-		while (cnt--)
-			*--p = *--s;
+	unsigned char *d = (unsigned char *)dst;
+	const unsigned char *s = (const unsigned char *)src;
+	word_t *wd;
+	const word_t *ws;
+
+	/* memcpy() only ever reads ahead of what it writes */
+	if (d <= s || d >= s + cnt)
+		return memcpy(dst, src, cnt);
+
+	d += cnt;
+	s += cnt;
+
+	/* backward, by words when both ends can be aligned together */
+	if (cnt >= SMALL_COPY &&
+	    !(((unsigned long)d ^ (unsigned long)s) & WORD_MASK)) {
+		while ((unsigned long)d & WORD_MASK) {
+			*--d = *--s;
+			cnt--;
 		}
 
+		wd = (word_t *)d;
+		ws = (const word_t *)s;
+		for (; cnt >= sizeof(word_t); cnt -= sizeof(word_t))
+			*--wd = *--ws;
+
+		d = (unsigned char *)wd;
+		s = (const unsigned char *)ws;
+	}
+
+	while (cnt--)
+		*--d = *--s;
+
 	return dst;
 }
@@ -16,15 +16,10 @@
 #include "autoconf.h"
 #include "optee.h"
 #include "sfr_aicredir.h"
+#include "bootstage.h"
+#include "task.h"
 
-#ifdef CONFIG_CACHES
-#include "l1cache.h"
-#endif
-
-#ifdef CONFIG_MMU
 #include "mmu.h"
-static unsigned int *tlb = (unsigned int *)MMU_TABLE_BASE_ADDR;
-#endif
 
 #ifdef CONFIG_HW_DISPLAY_BANNER
 static void display_banner (void)
@@ -41,6 +36,7 @@ int main(void)
 	int ret = 0;
 
 	hw_init();
+	bootstage_mark(BOOTSTAGE_HW_INIT);
 
 #ifdef CONFIG_OCMS_STATIC
 	ocms_init_keys();
@@ -64,12 +60,20 @@ int main(void)
 #endif
 		slowclk_switch_osc32();
 
+		usart_flush();
+
 		/* ...jump to Linux here */
 		return ret;
 	}
 	usart_puts("Backup mode enabled\n");
 #endif
 
+	/*
+	 * Not resuming: the DRAM holds nothing to keep, so the MMU table can
+	 * go there and the rest of the boot runs cached up to the handoff.
+	 */
+	mmu_caches_enable();
+
 #ifdef CONFIG_HW_DISPLAY_BANNER
 	display_banner();
 #endif
@@ -99,36 +103,26 @@ int main(void)
 #if defined(CONFIG_SAMA7G5) || defined(CONFIG_SAMA7D65)
 	hw_postinit();
 #endif
+	bootstage_mark(BOOTSTAGE_BOARD_INFO);
 
 #ifdef CONFIG_LOAD_SW
 	init_load_image(&image);
 
 #if defined(CONFIG_SECURE)
 	image.dest -= sizeof(at91_secure_header_t);
+	secure_stream_start(image.dest);
 #endif
 
-#ifdef CONFIG_MMU
-	mmu_tlb_init(tlb);
-	mmu_configure(tlb);
-	mmu_enable();
-#endif
-#ifdef CONFIG_CACHES
-	icache_enable();
-	dcache_enable();
-#endif
 	ret = (*load_image)(&image);
-#ifdef CONFIG_CACHES
-	icache_disable();
-	dcache_disable();
-#endif
-#ifdef CONFIG_MMU
-	mmu_disable();
-#endif
+	bootstage_mark(BOOTSTAGE_IMAGE_READ);
 
 #if defined(CONFIG_SECURE)
 	if (!ret)
 		ret = secure_check(image.dest);
+	else
+		secure_stream_abort();
 	image.dest += sizeof(at91_secure_header_t);
+	bootstage_mark(BOOTSTAGE_SECURE_CHECK);
 #endif
 
 #endif
@@ -142,6 +136,16 @@ int main(void)
 #endif
 #endif
 
+	/* the next stage expects the work of the boot tasks to be done */
+	task_wait_all();
+
+	bootstage_mark(BOOTSTAGE_HANDOFF);
+	bootstage_report();
+
+	/* nothing may be left queued once the next stage owns the console */
+	usart_flush();
+	mmu_caches_disable();
+
 #if defined(CONFIG_LOAD_OPTEE)
 	/* Will never return since we will jump to OP-TEE in secure mode */
 	optee_load();